@@ -1,8 +1,11 @@
 #include "benchmark.hpp"
 #include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
 #include "util.hpp"
 #include "profiling.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <chrono>
 #include <vector>
 #include <iomanip>
@@ -35,7 +38,8 @@ void print_numbers(std::string benchmark_name, std::vector<size_t> const& elapse
     std::cout << "] ms" << std::endl;
 }
 
-bool check_decompression_result(std::vector<uint16_t> input, int* output, size_t size)
+template <typename T>
+bool check_decompression_result(std::vector<uint16_t> const& input, T* output, size_t size)
 {
     for (size_t i = 0; i < size; i++)
     {
@@ -54,7 +58,8 @@ void do_decompression_benchmark(
     std::vector<uint16_t> input,
     size_t input_size, 
     __m128i* compressed_data,
-    std::function<void(__m128i*, size_t, int*)> decompression_function) 
+    size_t compression,
+    std::function<void(__m128i*, size_t, size_t, int*)> decompression_function) 
 {
     std::vector<size_t> elapsed_time_us(benchmark_repetitions);
     size_t output_buffer_size = decompression_output_buffer_size(input_size) / sizeof(int);
@@ -63,47 +68,121 @@ void do_decompression_benchmark(
     for (int i = 0; i < benchmark_repetitions; ++i)
     {
         _clock();
-        decompression_function(compressed_data, input_size, output_buffer.get());
+        decompression_function(compressed_data, input_size, compression, output_buffer.get());
         elapsed_time_us[i] = _clock().count();
     }
     print_numbers(name, elapsed_time_us);
     check_decompression_result(input, output_buffer.get(), input_size);
 }
 
-void bench_decompression(size_t data_size, size_t repetitions)
+template <typename T>
+void do_narrow_decompression_benchmark(
+    std::string name,
+    size_t benchmark_repetitions,
+    std::vector<uint16_t> const& input,
+    size_t input_size,
+    __m128i* compressed_data,
+    size_t compression,
+    std::function<void(__m128i*, size_t, size_t, T*)> decompression_function)
+{
+    std::vector<size_t> elapsed_time_us(benchmark_repetitions);
+    size_t output_buffer_size = decompression_output_buffer_size(input_size, sizeof(T)) / sizeof(T);
+    std::unique_ptr<T[]> output_buffer = std::make_unique<T[]>(output_buffer_size);
+
+    for (int i = 0; i < benchmark_repetitions; ++i)
+    {
+        _clock();
+        decompression_function(compressed_data, input_size, compression, output_buffer.get());
+        elapsed_time_us[i] = _clock().count();
+    }
+    print_numbers(name, elapsed_time_us);
+    check_decompression_result(input, output_buffer.get(), input_size);
+}
+
+void bench_decompression(size_t data_size, size_t repetitions, size_t compression)
 {
-    size_t compression = 9;
     size_t input_size = data_size * 8 / compression;
 
     std::vector<uint16_t> input(input_size);
     for (size_t i = 0; i < input_size; i++)
     {
-        input[i] = (uint16_t)(i & ((1 << compression) - 1));
+        input[i] = (uint16_t)(i & ((uint64_t(1) << compression) - 1));
     }
 
-    std::unique_ptr<uint64_t[]> compressed = compress_9bit_input(input);
+    std::unique_ptr<uint64_t[]> compressed = compress_input(input, compression);
     __m128i* compressed_ptr = (__m128i*) compressed.get();
 
+    std::unique_ptr<uint64_t[]> vertical = compress_vertical(input, compression);
+    __m128i* vertical_ptr = (__m128i*) vertical.get();
+
     std::cout << "## decompression benchmarks ##" << std::endl;
-    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes)" << std::endl;
-
-    do_decompression_benchmark("unvectorized", repetitions, input, input_size, compressed_ptr, decompress_unvectorized);
-    do_decompression_benchmark("sse 128 (sweep)", repetitions, input, input_size, compressed_ptr, decompress_128_sweep);
-    do_decompression_benchmark("sse 128 (load after 4)", repetitions, input, input_size, compressed_ptr, decompress_128_nosweep);
-    do_decompression_benchmark("sse 128 (9 bit optimized masks)", repetitions, input, input_size, compressed_ptr, decompress_128_9bit);
-    do_decompression_benchmark("sse 128 (optimized masks)", repetitions, input, input_size, compressed_ptr, decompress_128);
-    do_decompression_benchmark("sse 128 (optimized masks + unrolled loop)", repetitions, input, input_size, compressed_ptr, decompress_128_unrolled);
-    do_decompression_benchmark("sse 128 (optimized masks + aligned loads)", repetitions, input, input_size, compressed_ptr, decompress_128_aligned);
-
-#ifdef __AVX__
-    do_decompression_benchmark("avx 256", repetitions, input, input_size, compressed_ptr, decompress_256);
-#ifdef __AVX2__
-    do_decompression_benchmark("avx 256 (avx2 shift)", repetitions, input, input_size, compressed_ptr, decompress_256_avx2);
+    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes, " << compression << " bit)" << std::endl;
+
+    do_decompression_benchmark("unvectorized", repetitions, input, input_size, compressed_ptr, compression, decompress_unvectorized);
+#if ENABLE_BMI2
+    if (cpu_supports_bmi2())
+    {
+        do_decompression_benchmark("bmi2 (pdep)", repetitions, input, input_size, compressed_ptr, compression, decompress_bmi2);
+    }
 #endif
+    if (fits_shuffle_window(compression))
+    {
+        do_decompression_benchmark("sse 128 (sweep)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_sweep);
+        do_decompression_benchmark("sse 128 (load after 4)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_nosweep);
+        if (compression == 9)
+        {
+            do_decompression_benchmark("sse 128 (9 bit optimized masks)", repetitions, input, input_size, compressed_ptr, compression,
+                [](__m128i* input, size_t input_size, size_t, int* output) { decompress_128_9bit(input, input_size, output); });
+        }
+        do_decompression_benchmark("sse 128 (optimized masks)", repetitions, input, input_size, compressed_ptr, compression, decompress_128);
+        do_decompression_benchmark("sse 128 (optimized masks + unrolled loop)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_unrolled);
+        do_decompression_benchmark("sse 128 (optimized masks + aligned loads)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_aligned);
+    }
+    do_decompression_benchmark("sse 128 (wide)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_wide);
+    do_decompression_benchmark("sse 128 (width specialized)", repetitions, input, input_size, compressed_ptr, compression, decompress);
+    do_decompression_benchmark("sse 128 (vertical layout)", repetitions, input, input_size, vertical_ptr, compression, decompress_vertical_128);
+
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        if (fits_shuffle_window(compression))
+        {
+            do_decompression_benchmark("avx 256", repetitions, input, input_size, compressed_ptr, compression, decompress_256);
+            do_decompression_benchmark("avx 256 (avx2 shift)", repetitions, input, input_size, compressed_ptr, compression, decompress_256_avx2);
+            do_decompression_benchmark("avx 256 (32 byte loads)", repetitions, input, input_size, compressed_ptr, compression, decompress_256_permute);
+        }
+        do_decompression_benchmark("avx 256 (wide)", repetitions, input, input_size, compressed_ptr, compression, decompress_256_wide);
+        do_decompression_benchmark("avx 256 (vertical layout)", repetitions, input, input_size, vertical_ptr, compression, decompress_vertical_256);
+    }
+    else
+    {
+        std::cout << "avx 256 is not supported" << std::endl;
+    }
 #else
     std::cout << "avx 256 is not supported" << std::endl;
 #endif
 
+    if (compression <= 16)
+    {
+        do_narrow_decompression_benchmark<uint16_t>("sse 128 (16 bit output)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_16bit);
+#if ENABLE_AVX2
+        if (cpu_supports_avx2())
+        {
+            do_narrow_decompression_benchmark<uint16_t>("avx 256 (16 bit output)", repetitions, input, input_size, compressed_ptr, compression, decompress_256_16bit);
+        }
+#endif
+    }
+    if (compression <= 8)
+    {
+        do_narrow_decompression_benchmark<uint8_t>("sse 128 (8 bit output)", repetitions, input, input_size, compressed_ptr, compression, decompress_128_8bit);
+#if ENABLE_AVX2
+        if (cpu_supports_avx2())
+        {
+            do_narrow_decompression_benchmark<uint8_t>("avx 256 (8 bit output)", repetitions, input, input_size, compressed_ptr, compression, decompress_256_8bit);
+        }
+#endif
+    }
+
     std::cout << "finished benchmark" << std::endl;
 }
 
@@ -145,7 +224,8 @@ void do_scan_benchmark(
     std::vector<uint16_t> input,
     size_t input_size,
     __m128i* compressed_data,
-    std::function<int(int, __m128i*, size_t, std::vector<uint8_t>&)> scan_function)
+    size_t compression,
+    std::function<int(int, __m128i*, size_t, size_t, std::vector<uint8_t>&)> scan_function)
 {
     int predicate_key = 3;
     std::vector<size_t> elapsed_time_us(benchmark_repetitions);
@@ -155,16 +235,15 @@ void do_scan_benchmark(
     for (int i = 0; i < benchmark_repetitions; ++i)
     {
         _clock();
-        scan_function(predicate_key, compressed_data, input_size, output_buffer);
+        scan_function(predicate_key, compressed_data, input_size, compression, output_buffer);
         elapsed_time_us[i] = _clock().count();
     }
     print_numbers(name, elapsed_time_us);
     check_scan_result(input, input_size, output_buffer, predicate_key);
 }
 
-void bench_scan(size_t data_size, size_t repetitions) 
+void bench_scan(size_t data_size, size_t repetitions, size_t compression) 
 {
-    size_t compression = 9;
     size_t input_size = data_size * 8 / compression;
 
     std::vector<uint16_t> input(input_size);
@@ -173,19 +252,76 @@ void bench_scan(size_t data_size, size_t repetitions)
         input[i] = (uint16_t)(i % 5);
     }
 
-    std::unique_ptr<uint64_t[]> compressed = compress_9bit_input(input);
+    std::unique_ptr<uint64_t[]> compressed = compress_input(input, compression);
     __m128i* compressed_ptr = (__m128i*) compressed.get();
 
+    std::unique_ptr<uint64_t[]> vertical = compress_vertical(input, compression);
+    __m128i* vertical_ptr = (__m128i*) vertical.get();
+
+    std::unique_ptr<uint64_t[]> bitweaving_h = compress_bitweaving_h(input, compression);
+    __m128i* bitweaving_h_ptr = (__m128i*) bitweaving_h.get();
+
+    std::unique_ptr<uint64_t[]> bitweaving_v = compress_bitweaving_v(input, compression);
+    __m128i* bitweaving_v_ptr = (__m128i*) bitweaving_v.get();
+
+    std::unique_ptr<uint64_t[]> byteslice = compress_byteslice(input, compression);
+    __m128i* byteslice_ptr = (__m128i*) byteslice.get();
+
     std::cout << "## scan benchmarks ##" << std::endl;
-    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes)" << std::endl;
+    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes, " << compression << " bit)" << std::endl;
 
-    do_scan_benchmark("unvectorized", repetitions, input, input_size, compressed_ptr, scan_unvectorized);
-    do_scan_benchmark("sse 128", repetitions, input, input_size, compressed_ptr, scan_128);
-    do_scan_benchmark("sse 128 (unrolled)", repetitions, input, input_size, compressed_ptr, scan_128_unrolled);
+    do_scan_benchmark("unvectorized", repetitions, input, input_size, compressed_ptr, compression, scan_unvectorized);
+    do_scan_benchmark("swar 64 (bitweaving/h layout)", repetitions, input, input_size, bitweaving_h_ptr, compression, scan_bitweaving_h);
+#if ENABLE_BMI2
+    if (cpu_supports_bmi2())
+    {
+        do_scan_benchmark("bmi2 (pdep/pext)", repetitions, input, input_size, compressed_ptr, compression, scan_bmi2);
+    }
+#endif
+    if (fits_shuffle_window(compression))
+    {
+        do_scan_benchmark("sse 128", repetitions, input, input_size, compressed_ptr, compression, scan_128);
+        do_scan_benchmark("sse 128 (unrolled)", repetitions, input, input_size, compressed_ptr, compression, scan_128_unrolled);
+    }
+    do_scan_benchmark("sse 128 (wide)", repetitions, input, input_size, compressed_ptr, compression, scan_128_wide);
+    do_scan_benchmark("sse 128 (width specialized)", repetitions, input, input_size, compressed_ptr, compression, scan);
+    do_scan_benchmark("sse 128 (vertical layout)", repetitions, input, input_size, vertical_ptr, compression, scan_vertical_128);
+    do_scan_benchmark("sse 128 (bitweaving/v layout)", repetitions, input, input_size, bitweaving_v_ptr, compression, scan_bitweaving_v);
+    do_scan_benchmark("sse 128 (byteslice layout)", repetitions, input, input_size, byteslice_ptr, compression, scan_byteslice_128);
+    if (compression <= 16)
+    {
+        do_scan_benchmark("sse 128 (16 bit lanes)", repetitions, input, input_size, compressed_ptr, compression, scan_128_16bit);
+    }
+    if (compression <= 8)
+    {
+        do_scan_benchmark("sse 128 (8 bit lanes)", repetitions, input, input_size, compressed_ptr, compression, scan_128_8bit);
+    }
 
-#ifdef __AVX__
-    do_scan_benchmark("avx 256", repetitions, input, input_size, compressed_ptr, scan_256);
-    do_scan_benchmark("avx 256 (unrolled)", repetitions, input, input_size, compressed_ptr, scan_256_unrolled);
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        if (fits_shuffle_window(compression))
+        {
+            do_scan_benchmark("avx 256", repetitions, input, input_size, compressed_ptr, compression, scan_256);
+            do_scan_benchmark("avx 256 (unrolled)", repetitions, input, input_size, compressed_ptr, compression, scan_256_unrolled);
+            do_scan_benchmark("avx 256 (32 byte loads)", repetitions, input, input_size, compressed_ptr, compression, scan_256_permute);
+        }
+        do_scan_benchmark("avx 256 (wide)", repetitions, input, input_size, compressed_ptr, compression, scan_256_wide);
+        do_scan_benchmark("avx 256 (vertical layout)", repetitions, input, input_size, vertical_ptr, compression, scan_vertical_256);
+        do_scan_benchmark("avx 256 (byteslice layout)", repetitions, input, input_size, byteslice_ptr, compression, scan_byteslice_256);
+        if (compression <= 16)
+        {
+            do_scan_benchmark("avx 256 (16 bit lanes)", repetitions, input, input_size, compressed_ptr, compression, scan_256_16bit);
+        }
+        if (compression <= 8)
+        {
+            do_scan_benchmark("avx 256 (8 bit lanes)", repetitions, input, input_size, compressed_ptr, compression, scan_256_8bit);
+        }
+    }
+    else
+    {
+        std::cout << "avx 256 is not supported" << std::endl;
+    }
 #else
     std::cout << "avx 256 is not supported" << std::endl;
 #endif
@@ -199,7 +335,8 @@ void do_shared_scan_benchmark(
     std::vector<uint16_t> input,
     size_t input_size,
     __m128i* compressed_data,
-    std::function<void(std::vector<int> const&, __m128i*, size_t, std::vector<std::vector<uint8_t>>&)> shared_scan_function,
+    size_t compression,
+    std::function<void(std::vector<int> const&, __m128i*, size_t, size_t, std::vector<std::vector<uint8_t>>&)> shared_scan_function,
     int predicate_key_count)
 {
     std::vector<int> predicate_keys(predicate_key_count);
@@ -216,7 +353,7 @@ void do_shared_scan_benchmark(
     for (int i = 0; i < benchmark_repetitions; ++i)
     {
         _clock();
-        shared_scan_function(predicate_keys, compressed_data, input_size, output_buffers);
+        shared_scan_function(predicate_keys, compressed_data, input_size, compression, output_buffers);
         elapsed_time_us[i] = _clock().count();
     }
 
@@ -234,7 +371,8 @@ void do_shared_scan_linear_benchmark(
     std::vector<uint16_t> input,
     size_t input_size,
     __m128i* compressed_data,
-    std::function<void(const std::vector<int>&, __m128i*, size_t, std::vector<uint8_t>&)> shared_scan_function,
+    size_t compression,
+    std::function<void(const std::vector<int>&, __m128i*, size_t, size_t, std::vector<uint8_t>&)> shared_scan_function,
     int predicate_key_count)
 {
     std::vector<int> predicate_keys(predicate_key_count);
@@ -251,7 +389,7 @@ void do_shared_scan_linear_benchmark(
     for (int i = 0; i < benchmark_repetitions; ++i)
     {
         _clock();
-        shared_scan_function(predicate_keys, compressed_data, input_size, output_buffer);
+        shared_scan_function(predicate_keys, compressed_data, input_size, compression, output_buffer);
         elapsed_time_us[i] = _clock().count();
     }
 
@@ -260,9 +398,8 @@ void do_shared_scan_linear_benchmark(
     //check_scan_result(input, output_buffer, predicate_keys);
 }
 
-void bench_shared_scan(size_t data_size, size_t repetitions, int predicate_key_count, bool relative_data_size)
+void bench_shared_scan(size_t data_size, size_t repetitions, int predicate_key_count, bool relative_data_size, size_t compression)
 {
-    size_t compression = 9;
 
     if (relative_data_size)
     {
@@ -274,33 +411,171 @@ void bench_shared_scan(size_t data_size, size_t repetitions, int predicate_key_c
     std::vector<uint16_t> input(input_size);
     for (size_t i = 0; i < input_size; i++)
     {
-        input[i] = (uint16_t)(i % predicate_key_count % (1 << compression));
+        input[i] = (uint16_t)(i % predicate_key_count % (uint64_t(1) << compression));
     }
 
-    std::unique_ptr<uint64_t[]> compressed = compress_9bit_input(input);
+    std::unique_ptr<uint64_t[]> compressed = compress_input(input, compression);
     __m128i* compressed_ptr = (__m128i*) compressed.get();
 
     std::cout << "## shared scan benchmarks ##" << std::endl;
-    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes)" << std::endl;
+    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes, " << compression << " bit)" << std::endl;
     std::cout << "predicate key count: " << predicate_key_count << std::endl;
 
-    //do_shared_scan_benchmark("sse 128, sequential", repetitions, input, input_size, compressed_ptr, shared_scan_128_sequential, predicate_key_count);
-    do_shared_scan_benchmark("sse 128, sequential (unrolled)", repetitions, input, input_size, compressed_ptr, shared_scan_128_sequential_unrolled, predicate_key_count);
+    //do_shared_scan_benchmark("sse 128, sequential", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_sequential, predicate_key_count);
+    do_shared_scan_benchmark("sse 128, sequential (unrolled)", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_sequential_unrolled, predicate_key_count);
     
     int num_threads = omp_get_max_threads();
-    //do_shared_scan_benchmark("sse 128, threaded (" + std::to_string(num_threads) + " threads)", repetitions, input, input_size, compressed_ptr, shared_scan_128_threaded, predicate_key_count);
-    do_shared_scan_benchmark("sse 128, standard", repetitions, input, input_size, compressed_ptr, shared_scan_128_standard, predicate_key_count);
-    //do_shared_scan_benchmark("sse 128, standard (unrolled)", repetitions, input, input_size, compressed_ptr, shared_scan_128_standard_unrolled, predicate_key_count);
-    do_shared_scan_benchmark("sse 128, parallel", repetitions, input, input_size, compressed_ptr, shared_scan_128_parallel, predicate_key_count);
-
-    do_shared_scan_linear_benchmark("sse 128, linear, standard", repetitions, input, input_size, compressed_ptr, shared_scan_128_linear_standard, predicate_key_count);
-    //do_shared_scan_linear_benchmark("sse 128, linear, simple", repetitions, input, input_size, compressed_ptr, shared_scan_128_linear_simple, predicate_key_count);
-
-#ifdef __AVX__
-    // do_shared_scan_benchmark("avx 256, sequential", repetitions, input, input_size, compressed_ptr, shared_scan_256_sequential, predicate_key_count);
-    // do_shared_scan_benchmark("avx 256, standard", repetitions, input, input_size, compressed_ptr, shared_scan_256_standard, predicate_key_count);
-    // do_shared_scan_benchmark("avx 256, parallel", repetitions, input, input_size, compressed_ptr, shared_scan_256_parallel, predicate_key_count);
+    //do_shared_scan_benchmark("sse 128, threaded (" + std::to_string(num_threads) + " threads)", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_threaded, predicate_key_count);
+    do_shared_scan_benchmark("sse 128, standard", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_standard, predicate_key_count);
+    //do_shared_scan_benchmark("sse 128, standard (unrolled)", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_standard_unrolled, predicate_key_count);
+    do_shared_scan_benchmark("sse 128, parallel", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_parallel, predicate_key_count);
+    do_shared_scan_benchmark("sse 128, width specialized", repetitions, input, input_size, compressed_ptr, compression, shared_scan, predicate_key_count);
+    if (compression <= 16)
+    {
+        do_shared_scan_benchmark("sse 128, 16 bit lanes", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_16bit, predicate_key_count);
+    }
+
+    do_shared_scan_linear_benchmark("sse 128, linear, standard", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_linear_standard, predicate_key_count);
+    //do_shared_scan_linear_benchmark("sse 128, linear, simple", repetitions, input, input_size, compressed_ptr, compression, shared_scan_128_linear_simple, predicate_key_count);
+
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        // do_shared_scan_benchmark("avx 256, sequential", repetitions, input, input_size, compressed_ptr, compression, shared_scan_256_sequential, predicate_key_count);
+        // do_shared_scan_benchmark("avx 256, standard", repetitions, input, input_size, compressed_ptr, compression, shared_scan_256_standard, predicate_key_count);
+        // do_shared_scan_benchmark("avx 256, parallel", repetitions, input, input_size, compressed_ptr, compression, shared_scan_256_parallel, predicate_key_count);
+        if (fits_shuffle_window(compression))
+        {
+            do_shared_scan_benchmark("avx 256, 32 byte loads", repetitions, input, input_size, compressed_ptr, compression, shared_scan_256_permute, predicate_key_count);
+        }
+    }
+#endif
+
+    std::cout << "finished benchmark" << std::endl;
+}
+
+void bench_64bit(size_t data_size, size_t repetitions, size_t compression)
+{
+    size_t input_size = data_size * 8 / compression;
+    uint64_t mask = compression >= 64 ? ~uint64_t(0) : (uint64_t(1) << compression) - 1;
+
+    std::vector<uint64_t> input(input_size);
+    for (size_t i = 0; i < input_size; i++)
+    {
+        input[i] = (i * 0x9E3779B97F4A7C15ull) & mask;
+    }
+
+    std::unique_ptr<uint64_t[]> compressed = compress_input(input, compression);
+    __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+    std::cout << "## 64 bit benchmarks ##" << std::endl;
+    std::cout << "compressed input: " << input_size << " (" << data_size << " bytes, " << compression << " bit)" << std::endl;
+
+    auto output_buffer = std::make_unique<uint64_t[]>(decompression_output_buffer_size(input_size, sizeof(uint64_t)) / sizeof(uint64_t));
+    auto do_decompression_64bit_benchmark = [&](std::string name, std::function<void(__m128i*, size_t, size_t, uint64_t*)> function)
+    {
+        std::vector<size_t> elapsed_time_us(repetitions);
+        for (int i = 0; i < repetitions; ++i)
+        {
+            _clock();
+            function(compressed_ptr, input_size, compression, output_buffer.get());
+            elapsed_time_us[i] = _clock().count();
+        }
+        print_numbers(name, elapsed_time_us);
+        if (!std::equal(input.begin(), input.end(), output_buffer.get()))
+        {
+            std::cout << "(Error) decompression mismatch" << std::endl;
+        }
+    };
+
+    std::vector<uint8_t> scan_output(scan_output_buffer_size(input_size));
+    auto do_scan_64bit_benchmark = [&](std::string name, std::function<int(uint64_t, __m128i*, size_t, size_t, std::vector<uint8_t>&)> function)
+    {
+        uint64_t predicate_key = input[input_size / 2];
+        std::vector<size_t> elapsed_time_us(repetitions);
+        for (int i = 0; i < repetitions; ++i)
+        {
+            _clock();
+            function(predicate_key, compressed_ptr, input_size, compression, scan_output);
+            elapsed_time_us[i] = _clock().count();
+        }
+        print_numbers(name, elapsed_time_us);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            if (get_bit(scan_output, i) != (input[i] == predicate_key))
+            {
+                std::cout << "first mismatch at index " << i << std::endl;
+                break;
+            }
+        }
+    };
+
+    do_decompression_64bit_benchmark("decompression unvectorized", decompress_unvectorized_64bit);
+    do_scan_64bit_benchmark("scan unvectorized", scan_unvectorized_64bit);
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        do_decompression_64bit_benchmark("decompression avx 256", decompress_256_64bit);
+        do_scan_64bit_benchmark("scan avx 256", scan_256_64bit);
+    }
+    else
+    {
+        std::cout << "avx2 is not supported" << std::endl;
+    }
+#else
+    std::cout << "avx2 is not supported" << std::endl;
+#endif
+
+    std::cout << "finished benchmark" << std::endl;
+}
+
+void bench_compression(size_t data_size, size_t repetitions, size_t compression)
+{
+    size_t input_size = data_size * 8 / compression;
+
+    std::vector<uint32_t> input(input_size);
+    for (size_t i = 0; i < input_size; i++)
+    {
+        input[i] = (uint32_t)(i * 2654435761u) & code_mask(compression);
+    }
+
+    std::cout << "## compression benchmarks ##" << std::endl;
+    std::cout << "uncompressed input: " << input_size << " (" << input_size * sizeof(uint32_t) << " bytes, " << compression << " bit)" << std::endl;
+
+    std::unique_ptr<uint64_t[]> expected = compress_input(input, compression);
+    size_t compressed_size = compressed_buffer_size(compression, input_size) / sizeof(uint64_t) * sizeof(uint64_t);
+
+    auto do_compression_benchmark = [&](std::string name, std::function<std::unique_ptr<uint64_t[]>(std::vector<uint32_t> const&, size_t)> function)
+    {
+        std::vector<size_t> elapsed_time_us(repetitions);
+        std::unique_ptr<uint64_t[]> compressed;
+        for (int i = 0; i < repetitions; ++i)
+        {
+            _clock();
+            compressed = function(input, compression);
+            elapsed_time_us[i] = _clock().count();
+        }
+        print_numbers(name, elapsed_time_us);
+
+        // throughput in terms of the uncompressed input
+        size_t best = *std::min_element(elapsed_time_us.begin(), elapsed_time_us.end());
+        std::cout << "  throughput: " << ((double)(input_size * sizeof(uint32_t)) / best) << " GB/s" << std::endl;
+
+        if (memcmp(expected.get(), compressed.get(), compressed_size) != 0)
+        {
+            std::cout << "(Error) compressed output differs from compress_input" << std::endl;
+        }
+    };
+
+    do_compression_benchmark("unvectorized", compress_input<uint32_t>);
+#if ENABLE_BMI2
+    if (cpu_supports_bmi2())
+    {
+        do_compression_benchmark("bmi2 (pext)", compress_input_bmi2<uint32_t>);
+    }
 #endif
+    do_compression_benchmark("sse 128", compress_128<uint32_t>);
+    do_compression_benchmark("sse 128, parallel (" + std::to_string(omp_get_max_threads()) + " threads)", compress_128_parallel<uint32_t>);
 
     std::cout << "finished benchmark" << std::endl;
 }
@@ -1,13 +1,21 @@
 #pragma once
 #include <string>
 
+#include "simd_scan.hpp"
+
 const size_t default_data_size = 500 * 1 << 20;
 const size_t default_benchmark_repetitions = 5;
 
-void bench_decompression(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions);
-void bench_scan(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions);
+void bench_decompression(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions,
+                         size_t compression = BITS_NEEDED);
+void bench_scan(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions,
+                size_t compression = BITS_NEEDED);
 void bench_shared_scan(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions, 
-                       int predicate_key_count = 8, bool relative_data_size = false);
+                       int predicate_key_count = 8, bool relative_data_size = false, size_t compression = BITS_NEEDED);
+void bench_64bit(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions,
+                 size_t compression = 48);
+void bench_compression(size_t data_size = default_data_size, size_t benchmark_repetitions = default_benchmark_repetitions,
+                       size_t compression = BITS_NEEDED);
 
 // misc
 template<typename T> void bench_memory(size_t data_size = default_data_size);
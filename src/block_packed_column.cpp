@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstring>
+
+#include "block_packed_column.hpp"
+#include "simd_scan.hpp"
+#include "util.hpp"
+
+static_assert(sizeof(BlockHeader) == sizeof(uint64_t), "block header has to fill one word");
+
+BlockPackedColumn::BlockPackedColumn(std::vector<uint32_t> const& values, size_t block_size)
+    : element_count(values.size()), block_size(block_size)
+{
+    if (block_size == 0 || block_size % 8 != 0)
+    {
+        std::cerr << "block size " << block_size << " is not a multiple of 8!" << std::endl;
+        this->block_size = 1024;
+    }
+
+    block_count = (element_count + this->block_size - 1) / this->block_size;
+    std::vector<uint8_t> compressions(block_count);
+
+    // first pass: widths of the blocks and size of the buffer
+    buffer_words = 0;
+    for (size_t block = 0; block < block_count; block++)
+    {
+        auto begin = values.begin() + block * this->block_size;
+        auto end = values.begin() + std::min((block + 1) * this->block_size, element_count);
+
+        compressions[block] = (uint8_t)bits_needed(*std::max_element(begin, end));
+        buffer_words += 1 + ((end - begin) * compressions[block] + 63) / 64;
+    }
+    buffer_words += compressed_buffer_size(1, 0) / sizeof(uint64_t);
+
+    // second pass: headers and packed data, the padding written behind a block is overwritten by the next one
+    buffer = std::make_unique<uint64_t[]>(buffer_words);
+    for (size_t block = 0, offset = 0; block < block_count; block++, offset = next_block(offset))
+    {
+        size_t count = block_elements(block);
+
+        BlockHeader block_header = {};
+        block_header.words = (uint32_t)((count * compressions[block] + 63) / 64);
+        block_header.compression = compressions[block];
+        memcpy(&buffer[offset], &block_header, sizeof(block_header));
+
+        compress_128_into(&values[block * this->block_size], count, compressions[block], (uint8_t*)block_data(offset));
+    }
+}
+
+BlockHeader const& BlockPackedColumn::header(size_t offset) const
+{
+    return *(BlockHeader const*)&buffer[offset];
+}
+
+__m128i* BlockPackedColumn::block_data(size_t offset) const
+{
+    return (__m128i*)&buffer[offset + 1];
+}
+
+size_t BlockPackedColumn::next_block(size_t offset) const
+{
+    return offset + 1 + header(offset).words;
+}
+
+size_t BlockPackedColumn::block_elements(size_t block) const
+{
+    return std::min(block_size, element_count - block * block_size);
+}
+
+void BlockPackedColumn::decompress(int* output) const
+{
+    for (size_t block = 0, offset = 0; block < block_count; block++, offset = next_block(offset))
+    {
+        ::decompress(block_data(offset), block_elements(block), header(offset).compression, output + block * block_size);
+    }
+}
+
+int BlockPackedColumn::scan_equal(uint32_t value, std::vector<uint8_t>& output) const
+{
+    std::vector<uint8_t> block_output(scan_output_buffer_size(block_size));
+
+    int hits = 0;
+    for (size_t block = 0, offset = 0; block < block_count; block++, offset = next_block(offset))
+    {
+        size_t count = block_elements(block);
+        hits += scan(value, block_data(offset), count, header(offset).compression, block_output);
+        memcpy(&output[block * block_size / 8], block_output.data(), (count + 7) / 8);
+    }
+    return hits;
+}
+
+int BlockPackedColumn::scan_between(uint32_t low, uint32_t high, std::vector<uint8_t>& output) const
+{
+    std::vector<uint8_t> block_output(scan_output_buffer_size(block_size));
+
+    int hits = 0;
+    for (size_t block = 0, offset = 0; block < block_count; block++, offset = next_block(offset))
+    {
+        size_t count = block_elements(block);
+        hits += scan_range(low, high, block_data(offset), count, header(offset).compression, block_output);
+        memcpy(&output[block * block_size / 8], block_output.data(), (count + 7) / 8);
+    }
+    return hits;
+}
+
+size_t BlockPackedColumn::size() const
+{
+    return element_count;
+}
+
+size_t BlockPackedColumn::get_block_count() const
+{
+    return block_count;
+}
+
+size_t BlockPackedColumn::get_block_compression(size_t block) const
+{
+    size_t offset = 0;
+    for (size_t i = 0; i < block; i++)
+    {
+        offset = next_block(offset);
+    }
+    return header(offset).compression;
+}
+
+size_t BlockPackedColumn::compressed_size() const
+{
+    return buffer_words * sizeof(uint64_t);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <immintrin.h>
+#include <memory>
+#include <vector>
+
+/*
+* Column packed with a separate bit width per block (values up to 32 bits)
+*
+* Each block of block_size values (a multiple of 8) starts with an 8 byte header, followed by its
+* elements packed with the minimal width of the block. The header stores the size of the packed
+* data, so the blocks are found by walking the buffer. Scans and decompression call the width
+* dispatched kernels once per block, so an outlier only widens its own block.
+*
+* buffer: | header | block 0 | header | block 1 | ... | padding (256 bytes) |
+*/
+
+struct BlockHeader
+{
+    uint32_t words;       // packed data of the block in 64 bit words
+    uint8_t compression;
+    uint8_t reserved[3];
+};
+
+class BlockPackedColumn
+{
+private:
+    size_t element_count;
+    size_t block_size;
+    size_t block_count;
+    size_t buffer_words;
+    std::unique_ptr<uint64_t[]> buffer;
+
+    // offset is the word index of a block header
+    BlockHeader const& header(size_t offset) const;
+
+    __m128i* block_data(size_t offset) const;
+
+    // word index of the header of the following block
+    size_t next_block(size_t offset) const;
+
+    size_t block_elements(size_t block) const;
+
+public:
+    BlockPackedColumn(std::vector<uint32_t> const& values, size_t block_size = 1024);
+
+    // output sized with decompression_output_buffer_size(size())
+    void decompress(int* output) const;
+
+    int scan_equal(uint32_t value, std::vector<uint8_t>& output) const;
+
+    // low <= value <= high
+    int scan_between(uint32_t low, uint32_t high, std::vector<uint8_t>& output) const;
+
+    size_t size() const;
+
+    size_t get_block_count() const;
+
+    size_t get_block_compression(size_t block) const;
+
+    // bytes of the buffer, including headers and padding
+    size_t compressed_size() const;
+};
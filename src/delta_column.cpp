@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "delta_column.hpp"
+#include "simd_scan.hpp"
+#include "util.hpp"
+
+DeltaColumn::DeltaColumn(std::vector<int64_t> const& values, size_t checkpoint_interval)
+    : compression(1), element_count(values.size()), checkpoint_interval(checkpoint_interval)
+{
+    if (checkpoint_interval == 0 || checkpoint_interval % 32 != 0)
+    {
+        throw std::invalid_argument("checkpoint interval " + std::to_string(checkpoint_interval) + " is not a multiple of 32");
+    }
+
+    std::vector<uint64_t> deltas(values.size());
+    uint64_t max_delta = 0;
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        // the checkpoints have to be sorted as well, the scans search them
+        if (i > 0 && values[i] < values[i - 1])
+        {
+            throw std::invalid_argument("values are not sorted at index " + std::to_string(i));
+        }
+
+        if (i % checkpoint_interval == 0)
+        {
+            checkpoints.push_back(values[i]);
+            continue;
+        }
+
+        deltas[i] = uint64_t(values[i]) - uint64_t(values[i - 1]);
+        max_delta = std::max(max_delta, deltas[i]);
+    }
+
+    compression = bits_needed(max_delta);
+
+    if (compression > 32)
+    {
+        buffer = compress_input(deltas, compression);
+        return;
+    }
+
+    buffer = compress_128(std::vector<uint32_t>(deltas.begin(), deltas.end()), compression);
+}
+
+void DeltaColumn::decompress(int64_t* output) const
+{
+    decompress_range(0, element_count, output);
+}
+
+void DeltaColumn::decompress_range(size_t begin, size_t end, int64_t* output) const
+{
+    end = std::min(end, element_count);
+    std::vector<int64_t> block;
+
+    for (size_t checkpoint = begin / checkpoint_interval; checkpoint * checkpoint_interval < end; checkpoint++)
+    {
+        size_t block_begin = checkpoint * checkpoint_interval;
+        size_t block_end = std::min(block_begin + checkpoint_interval, end);
+
+        if (block_begin >= begin)
+        {
+            decode_block(checkpoint, block_begin, block_end, output + (block_begin - begin));
+        }
+        else
+        {
+            // decoding has to start at the checkpoint, only the requested part is copied
+            block.resize(block_end - block_begin);
+            decode_block(checkpoint, block_begin, block_end, block.data());
+            std::copy(block.begin() + (begin - block_begin), block.end(), output);
+        }
+    }
+}
+
+void DeltaColumn::decode_block(size_t checkpoint, size_t begin, size_t end, int64_t* output) const
+{
+    if (compression <= 32)
+    {
+        decompress_delta(data(), begin, end, compression, checkpoints[checkpoint], output);
+        return;
+    }
+
+    // begin is a multiple of 32, so the deltas start at a byte boundary
+    __m128i* input = (__m128i*)((uint8_t*)data() + begin * compression / 8);
+    decompress_64bit(input, end - begin, compression, (uint64_t*)output);
+
+    uint64_t value = uint64_t(checkpoints[checkpoint]);
+    for (size_t i = 0; i < end - begin; i++)
+    {
+        value += uint64_t(output[i]);
+        output[i] = (int64_t)value;
+    }
+}
+
+int64_t DeltaColumn::get(size_t index) const
+{
+    if (index >= element_count)
+    {
+        throw std::out_of_range("index " + std::to_string(index) + " is out of range for " + std::to_string(element_count) + " values");
+    }
+
+    int64_t value;
+    decompress_range(index, index + 1, &value);
+    return value;
+}
+
+size_t DeltaColumn::bound(int64_t key, bool upper) const
+{
+    // the checkpoint before the first one that satisfies the bound contains the result (or it's that checkpoint)
+    auto it = upper
+        ? std::upper_bound(checkpoints.begin(), checkpoints.end(), key)
+        : std::lower_bound(checkpoints.begin(), checkpoints.end(), key);
+    size_t checkpoint = it - checkpoints.begin();
+    if (checkpoint == 0) return 0;
+
+    size_t block_begin = (checkpoint - 1) * checkpoint_interval;
+    size_t block_end = std::min(block_begin + checkpoint_interval, element_count);
+
+    std::vector<int64_t> block(block_end - block_begin);
+    decode_block(checkpoint - 1, block_begin, block_end, block.data());
+
+    auto position = upper
+        ? std::upper_bound(block.begin(), block.end(), key)
+        : std::lower_bound(block.begin(), block.end(), key);
+    return block_begin + (position - block.begin());
+}
+
+int DeltaColumn::scan_equal(int64_t value, std::vector<uint8_t>& output) const
+{
+    return scan_between(value, value, output);
+}
+
+int DeltaColumn::scan_between(int64_t low, int64_t high, std::vector<uint8_t>& output) const
+{
+    std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+    if (low > high) return 0;
+
+    size_t first = bound(low, false);
+    size_t last = bound(high, true);
+    if (first >= last) return 0;
+
+    set_bits(output, first, last);
+    return (int)(last - first);
+}
+
+size_t DeltaColumn::size() const
+{
+    return element_count;
+}
+
+size_t DeltaColumn::get_compression() const
+{
+    return compression;
+}
+
+__m128i* DeltaColumn::data() const
+{
+    return (__m128i*)buffer.get();
+}
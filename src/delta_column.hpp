@@ -0,0 +1,56 @@
+#pragma once
+
+#include <immintrin.h>
+#include <memory>
+#include <vector>
+
+/*
+* Delta encoded column of sorted (non-decreasing) values
+*
+* The differences to the previous value are packed with the minimal width, differences over
+* 32 bits are packed and decoded with the 64 bit kernels. Every checkpoint_interval values the
+* absolute value is stored as checkpoint and the difference of that element is packed as 0, so
+* decoding can start at any checkpoint (see decompress_delta).
+* Since the values are sorted, range predicates select a contiguous run of elements which is found
+* by a binary search over the checkpoints and decoding the two blocks at its ends.
+*/
+
+class DeltaColumn
+{
+private:
+    size_t compression;
+    size_t element_count;
+    size_t checkpoint_interval;
+    std::vector<int64_t> checkpoints;
+    std::unique_ptr<uint64_t[]> buffer;
+
+    // first index with value >= key (upper == false) or value > key (upper == true)
+    size_t bound(int64_t key, bool upper) const;
+
+    // values [begin, end) of the block starting at checkpoint, begin has to be a multiple of 32
+    void decode_block(size_t checkpoint, size_t begin, size_t end, int64_t* output) const;
+
+public:
+    // throws std::invalid_argument if the values aren't sorted or checkpoint_interval isn't a multiple of 32
+    DeltaColumn(std::vector<int64_t> const& values, size_t checkpoint_interval = 1024);
+
+    // output sized with decompression_output_buffer_size(size(), sizeof(int64_t))
+    void decompress(int64_t* output) const;
+
+    // values [begin, end) to output[0, end - begin)
+    void decompress_range(size_t begin, size_t end, int64_t* output) const;
+
+    // throws std::out_of_range if index >= size()
+    int64_t get(size_t index) const;
+
+    int scan_equal(int64_t value, std::vector<uint8_t>& output) const;
+
+    // low <= value <= high
+    int scan_between(int64_t low, int64_t high, std::vector<uint8_t>& output) const;
+
+    size_t size() const;
+
+    size_t get_compression() const;
+
+    __m128i* data() const;
+};
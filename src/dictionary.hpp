@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "simd_scan.hpp"
+#include "util.hpp"
+
+/*
+* Order-preserving dictionary encoding (int64_t, double, std::string, ...)
+*
+* The dictionary holds the distinct values of a column in sorted order, the code of a value is its
+* index. Codes are packed with the minimal width, and since code order equals value order every
+* value predicate maps to a range of codes, which is evaluated on the packed codes directly.
+* Values have to be totally ordered by operator<, i.e. no NaN for double.
+*/
+
+// inclusive range of codes, empty if low > high
+struct CodeRange
+{
+    uint32_t low;
+    uint32_t high;
+
+    bool empty() const { return low > high; }
+};
+
+template <typename T>
+class Dictionary
+{
+private:
+    std::vector<T> values;
+
+    // codes [begin, end) as CodeRange
+    static CodeRange make_range(size_t begin, size_t end)
+    {
+        if (begin >= end) return { 1, 0 };
+        return { (uint32_t)begin, (uint32_t)(end - 1) };
+    }
+
+    size_t lower_bound(T const& value) const
+    {
+        return std::lower_bound(values.begin(), values.end(), value) - values.begin();
+    }
+
+    size_t upper_bound(T const& value) const
+    {
+        return std::upper_bound(values.begin(), values.end(), value) - values.begin();
+    }
+
+public:
+    Dictionary(std::vector<T> const& column)
+        : values(column)
+    {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+    }
+
+    size_t size() const
+    {
+        return values.size();
+    }
+
+    // minimal number of bits for the codes 0 .. size() - 1 (at least 1)
+    size_t compression() const
+    {
+        return values.size() <= 1 ? 1 : bits_needed(values.size() - 1);
+    }
+
+    T const& decode(uint32_t code) const
+    {
+        return values[code];
+    }
+
+    // codes of the column values, all of them have to be in the dictionary
+    std::vector<uint32_t> encode(std::vector<T> const& column) const
+    {
+        std::vector<uint32_t> codes(column.size());
+        for (size_t i = 0; i < column.size(); i++)
+        {
+            codes[i] = (uint32_t)lower_bound(column[i]);
+        }
+        return codes;
+    }
+
+    std::unique_ptr<uint64_t[]> compress(std::vector<T> const& column) const
+    {
+        return compress_128(encode(column), compression());
+    }
+
+    /*
+    * Predicate translation
+    */
+
+    CodeRange equal(T const& value) const
+    {
+        return make_range(lower_bound(value), upper_bound(value));
+    }
+
+    CodeRange less_than(T const& value) const
+    {
+        return make_range(0, lower_bound(value));
+    }
+
+    CodeRange less_equal(T const& value) const
+    {
+        return make_range(0, upper_bound(value));
+    }
+
+    CodeRange greater_than(T const& value) const
+    {
+        return make_range(upper_bound(value), values.size());
+    }
+
+    CodeRange greater_equal(T const& value) const
+    {
+        return make_range(lower_bound(value), values.size());
+    }
+
+    // low <= value <= high
+    CodeRange between(T const& low, T const& high) const
+    {
+        return make_range(lower_bound(low), upper_bound(high));
+    }
+
+    // scans the packed codes (see compress) for a translated predicate
+    int scan(CodeRange const& range, __m128i* input, size_t input_size, std::vector<uint8_t>& output) const
+    {
+        if (range.empty())
+        {
+            std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+            return 0;
+        }
+
+        if (range.low == range.high)
+        {
+            return ::scan(range.low, input, input_size, compression(), output);
+        }
+
+        return scan_range(range.low, range.high, input, input_size, compression(), output);
+    }
+};
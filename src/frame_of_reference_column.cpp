@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "frame_of_reference_column.hpp"
+#include "simd_scan.hpp"
+
+FrameOfReferenceColumn::FrameOfReferenceColumn(std::vector<int64_t> const& values)
+    : base(0), compression(1), element_count(values.size())
+{
+    if (!values.empty())
+    {
+        auto minmax = std::minmax_element(values.begin(), values.end());
+        base = *minmax.first;
+
+        // unsigned difference, the spread of two int64_t values can exceed INT64_MAX
+        uint64_t spread = uint64_t(*minmax.second) - uint64_t(base);
+        compression = bits_needed(spread);
+    }
+
+    if (compression > 32)
+    {
+        std::vector<uint64_t> codes(values.size());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            codes[i] = uint64_t(values[i]) - uint64_t(base);
+        }
+
+        buffer = compress_input(codes, compression);
+        return;
+    }
+
+    std::vector<uint32_t> codes(values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        codes[i] = (uint32_t)(uint64_t(values[i]) - uint64_t(base));
+    }
+
+    buffer = compress_128(codes, compression);
+}
+
+bool FrameOfReferenceColumn::to_code(int64_t value, uint64_t& code) const
+{
+    if (value < base) return false;
+
+    uint64_t difference = uint64_t(value) - uint64_t(base);
+    if (difference > max_code()) return false;
+
+    code = difference;
+    return true;
+}
+
+uint64_t FrameOfReferenceColumn::max_code() const
+{
+    return compression >= 64 ? ~uint64_t(0) : (uint64_t(1) << compression) - 1;
+}
+
+void FrameOfReferenceColumn::decompress(int64_t* output) const
+{
+    if (compression > 32)
+    {
+        decompress_for_64bit(data(), element_count, compression, base, output);
+        return;
+    }
+
+    decompress_for(data(), element_count, compression, base, output);
+}
+
+int FrameOfReferenceColumn::scan_equal(int64_t value, std::vector<uint8_t>& output) const
+{
+    uint64_t code;
+    if (!to_code(value, code))
+    {
+        std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+        return 0;
+    }
+
+    if (compression > 32) return scan_64bit(code, data(), element_count, compression, output);
+
+    return scan((uint32_t)code, data(), element_count, compression, output);
+}
+
+int FrameOfReferenceColumn::scan_between(int64_t low, int64_t high, std::vector<uint8_t>& output) const
+{
+    // clamp the predicate to the codes [0, max_code]
+    uint64_t code_low = 0;
+    uint64_t code_high = max_code();
+
+    bool empty = high < base || low > high;
+    if (!empty && low > base && !to_code(low, code_low)) empty = true;
+    if (!empty && !to_code(high, code_high)) code_high = max_code();
+
+    if (empty)
+    {
+        std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+        return 0;
+    }
+
+    if (compression > 32) return scan_range_64bit(code_low, code_high, data(), element_count, compression, output);
+
+    return scan_range((uint32_t)code_low, (uint32_t)code_high, data(), element_count, compression, output);
+}
+
+size_t FrameOfReferenceColumn::size() const
+{
+    return element_count;
+}
+
+int64_t FrameOfReferenceColumn::get_base() const
+{
+    return base;
+}
+
+size_t FrameOfReferenceColumn::get_compression() const
+{
+    return compression;
+}
+
+__m128i* FrameOfReferenceColumn::data() const
+{
+    return (__m128i*)buffer.get();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <immintrin.h>
+#include <memory>
+#include <vector>
+
+/*
+* Frame of reference encoded column
+*
+* The minimum of the values is stored as base and value - base is packed with the minimal width.
+* Predicates are rewritten into the packed domain by subtracting the base, so scans never
+* reconstruct the values. decompress adds the base back within the SIMD loop (see decompress_for).
+* Values that spread over more than 32 bits (e.g. millisecond timestamps over more than 49 days)
+* are packed and scanned with the 64 bit kernels.
+*/
+
+class FrameOfReferenceColumn
+{
+private:
+    int64_t base;
+    size_t compression;
+    size_t element_count;
+    std::unique_ptr<uint64_t[]> buffer;
+
+    // value - base if it is representable with compression bits
+    bool to_code(int64_t value, uint64_t& code) const;
+
+    uint64_t max_code() const;
+
+public:
+    FrameOfReferenceColumn(std::vector<int64_t> const& values);
+
+    // output sized with decompression_output_buffer_size(size(), sizeof(int64_t))
+    void decompress(int64_t* output) const;
+
+    int scan_equal(int64_t value, std::vector<uint8_t>& output) const;
+
+    // low <= value <= high
+    int scan_between(int64_t low, int64_t high, std::vector<uint8_t>& output) const;
+
+    size_t size() const;
+
+    int64_t get_base() const;
+
+    size_t get_compression() const;
+
+    __m128i* data() const;
+};
@@ -14,7 +14,8 @@ void print_cmd_help()
     std::cout << "Format: ./shared_simd_scan data_size repetitions bench_name [bench_args...]" << std::endl;
     std::cout << "data_size = _ (for default) | number (in megabytes)" << std::endl;
     std::cout << "repetitions = _ (for default) | number (for number of repetitions" << std::endl;
-    std::cout << "bench_name = memory | decompression | scan | sharedscan [predicate_count] " << std::endl;
+    std::cout << "bench_name = memory | decompression [compression] | scan [compression] | sharedscan [predicate_count] [compression] | 64bit [compression] | compression [compression]" << std::endl;
+    std::cout << "compression = number of bits per element (default " << BITS_NEEDED << ")" << std::endl;
 }
 
 int arg_main(int argc, char** argv)
@@ -48,11 +49,23 @@ int arg_main(int argc, char** argv)
     }
     else if (strcmp(bench_name, "decompression") == 0)
     {
-        bench_decompression(data_size, repetitions);
+        size_t compression = BITS_NEEDED;
+        if (argc > 4)
+        {
+            compression = atoi(argv[4]);
+        }
+
+        bench_decompression(data_size, repetitions, compression);
     }
     else if (strcmp(bench_name, "scan") == 0)
     {
-        bench_scan(data_size, repetitions);
+        size_t compression = BITS_NEEDED;
+        if (argc > 4)
+        {
+            compression = atoi(argv[4]);
+        }
+
+        bench_scan(data_size, repetitions, compression);
     }
     else if (strcmp(bench_name, "sharedscan") == 0)
     {
@@ -62,7 +75,33 @@ int arg_main(int argc, char** argv)
             predicate_count = atoi(argv[4]);
         }
 
-        bench_shared_scan(data_size, repetitions, predicate_count);
+        size_t compression = BITS_NEEDED;
+        if (argc > 5)
+        {
+            compression = atoi(argv[5]);
+        }
+
+        bench_shared_scan(data_size, repetitions, predicate_count, false, compression);
+    }
+    else if (strcmp(bench_name, "64bit") == 0)
+    {
+        size_t compression = 48;
+        if (argc > 4)
+        {
+            compression = atoi(argv[4]);
+        }
+
+        bench_64bit(data_size, repetitions, compression);
+    }
+    else if (strcmp(bench_name, "compression") == 0)
+    {
+        size_t compression = BITS_NEEDED;
+        if (argc > 4)
+        {
+            compression = atoi(argv[4]);
+        }
+
+        bench_compression(data_size, repetitions, compression);
     }
     else
     {
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstring>
+
+#include "packed_column.hpp"
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+
+static size_t buffer_words(size_t compression, size_t capacity)
+{
+    return compressed_buffer_size(compression, capacity) / sizeof(uint64_t);
+}
+
+PackedColumn::PackedColumn(size_t compression, size_t initial_capacity)
+    : compression(compression), element_count(0), element_capacity(initial_capacity),
+      buffer(std::make_unique<uint64_t[]>(buffer_words(compression, initial_capacity)))
+{ }
+
+template <typename T>
+void PackedColumn::append(std::vector<T> const& values)
+{
+    size_t required_capacity = element_count + values.size();
+    if (required_capacity > element_capacity)
+    {
+        reserve(std::max(required_capacity, 2 * element_capacity));
+    }
+
+    uint8_t* output = (uint8_t*)buffer.get();
+
+    // fill up the last group of 8 elements, the rest of the batch then starts at a byte boundary
+    size_t i = 0;
+    for (; i < values.size() && element_count % 8 != 0; i++, element_count++)
+    {
+        size_t bit_index = element_count * compression;
+
+        uint64_t word;
+        memcpy(&word, output + bit_index / 8, sizeof(word));
+        word |= (uint64_t(values[i]) & code_mask(compression)) << (bit_index % 8);
+        memcpy(output + bit_index / 8, &word, sizeof(word));
+    }
+
+    compress_128_into(values.data() + i, values.size() - i, compression, output + element_count * compression / 8);
+    element_count += values.size() - i;
+}
+
+template void PackedColumn::append<uint16_t>(std::vector<uint16_t> const& values);
+template void PackedColumn::append<uint32_t>(std::vector<uint32_t> const& values);
+
+void PackedColumn::reserve(size_t capacity)
+{
+    if (capacity <= element_capacity) return;
+
+    // the new buffer is zero initialized, including the bits behind the last element
+    auto new_buffer = std::make_unique<uint64_t[]>(buffer_words(compression, capacity));
+    memcpy(new_buffer.get(), buffer.get(), (element_count * compression + 7) / 8);
+
+    buffer = std::move(new_buffer);
+    element_capacity = capacity;
+}
+
+size_t PackedColumn::size() const
+{
+    return element_count;
+}
+
+size_t PackedColumn::capacity() const
+{
+    return element_capacity;
+}
+
+size_t PackedColumn::get_compression() const
+{
+    return compression;
+}
+
+__m128i* PackedColumn::data() const
+{
+    return (__m128i*)buffer.get();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <immintrin.h>
+#include <memory>
+#include <vector>
+
+/*
+* Appendable column of packed elements (compression 1-32)
+*
+* Batches are packed directly behind the existing elements with compress_128, so the buffer always
+* has the layout of compress_input and can be passed to all decompression and scan kernels
+* (data(), size(), get_compression()). The capacity grows geometrically, every reallocation keeps
+* the padding of compressed_buffer_size.
+*/
+
+class PackedColumn
+{
+private:
+    size_t compression;
+    size_t element_count;
+    size_t element_capacity;
+    std::unique_ptr<uint64_t[]> buffer;
+
+public:
+    PackedColumn(size_t compression, size_t initial_capacity = 0);
+
+    template <typename T>
+    void append(std::vector<T> const& values);
+
+    void reserve(size_t capacity);
+
+    size_t size() const;
+
+    size_t capacity() const;
+
+    size_t get_compression() const;
+
+    __m128i* data() const;
+};
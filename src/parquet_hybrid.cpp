@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstring>
+
+#include "parquet_hybrid.hpp"
+#include "simd_scan.hpp"
+#include "util.hpp"
+
+// bytes behind a bit-packed run the SIMD kernels may read (padding of compressed_buffer_size)
+static const size_t kernel_padding = compressed_buffer_size(1, 0);
+
+static bool read_uleb128(const uint8_t*& position, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (size_t shift = 0; shift < 64 && position < end; shift += 7)
+    {
+        uint8_t byte = *position++;
+        value |= uint64_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+ParquetHybridDecoder::ParquetHybridDecoder(const uint8_t* data, size_t size, size_t bit_width, size_t value_count)
+    : bit_width(bit_width), value_count(value_count), is_valid(true)
+{
+    // the hybrid encoding is decoded up to 32 bits
+    if (bit_width > 32)
+    {
+        is_valid = false;
+        this->value_count = 0;
+        return;
+    }
+
+    if (!parse(data, size))
+    {
+        is_valid = false;
+        this->value_count = 0;
+        runs.clear();
+        tail.reset();
+    }
+}
+
+ParquetHybridDecoder ParquetHybridDecoder::dictionary_indices(const uint8_t* data, size_t size, size_t value_count)
+{
+    if (size == 0) return ParquetHybridDecoder(data, 0, 0, value_count);
+
+    return ParquetHybridDecoder(data + 1, size - 1, data[0], value_count);
+}
+
+ParquetHybridDecoder ParquetHybridDecoder::levels(const uint8_t* data, size_t size, size_t bit_width, size_t value_count)
+{
+    uint32_t length = 0;
+    if (size >= sizeof(length))
+    {
+        memcpy(&length, data, sizeof(length));
+    }
+
+    size_t available = size >= sizeof(length) ? size - sizeof(length) : 0;
+    return ParquetHybridDecoder(data + sizeof(length), std::min<size_t>(length, available), bit_width, value_count);
+}
+
+bool ParquetHybridDecoder::parse(const uint8_t* data, size_t size)
+{
+    const uint8_t* position = data;
+    const uint8_t* end = data + size;
+    size_t value_bytes = (bit_width + 7) / 8;
+
+    size_t decoded = 0;
+    while (decoded < value_count)
+    {
+        uint64_t header;
+        if (!read_uleb128(position, end, header)) return false;
+
+        Run run = {};
+        run.begin = decoded;
+
+        if (header & 1)
+        {
+            // bit-packed run, groups of 8 values
+            uint64_t groups = header >> 1;
+            if (bit_width > 0 && groups > uint64_t(end - position) / bit_width) return false;
+
+            size_t bytes = groups * bit_width;
+
+            size_t remaining = value_count - decoded;
+            run.count = std::min<size_t>((size_t)std::min<uint64_t>(groups, (remaining + 7) / 8) * 8, remaining);
+            run.packed = bit_width > 0; // zero width runs are runs of zeros
+            run.data = position;
+            position += bytes;
+        }
+        else
+        {
+            if (value_bytes > size_t(end - position)) return false;
+
+            run.count = (size_t)std::min<uint64_t>(header >> 1, value_count - decoded);
+            for (size_t i = 0; i < value_bytes; i++)
+            {
+                run.value |= uint32_t(position[i]) << (8 * i);
+            }
+            position += value_bytes;
+        }
+
+        decoded += run.count;
+        if (run.count > 0) runs.push_back(run);
+    }
+
+    // the SIMD kernels read up to kernel_padding bytes behind the data of a run, the last runs are copied
+    auto needs_copy = [&](Run const& run)
+    {
+        return run.packed && size_t(end - run.data) < (run.count * bit_width + 7) / 8 + kernel_padding;
+    };
+
+    auto first = std::find_if(runs.begin(), runs.end(), needs_copy);
+    if (first != runs.end())
+    {
+        const uint8_t* copy_begin = first->data;
+        size_t copy_size = end - copy_begin;
+
+        tail = std::make_unique<uint64_t[]>((copy_size + kernel_padding + 7) / sizeof(uint64_t));
+        memcpy(tail.get(), copy_begin, copy_size);
+
+        for (auto run = first; run != runs.end(); run++)
+        {
+            if (run->packed) run->data = (uint8_t*)tail.get() + (run->data - copy_begin);
+        }
+    }
+
+    return true;
+}
+
+void ParquetHybridDecoder::decode(int* output) const
+{
+    for (Run const& run : runs)
+    {
+        if (run.packed)
+        {
+            decompress((__m128i*)run.data, run.count, bit_width, output + run.begin);
+        }
+        else
+        {
+            std::fill(output + run.begin, output + run.begin + run.count, (int)run.value);
+        }
+    }
+}
+
+// ors count bits into the bitmap at position, the bits behind count have to be zero
+static void __merge_bits(std::vector<uint8_t> const& bits, size_t count, std::vector<uint8_t>& output, size_t position)
+{
+    size_t bytes = (count + 7) / 8;
+    size_t shift = position % 8;
+    uint8_t* destination = &output[position / 8];
+
+    if (shift == 0)
+    {
+        memcpy(destination, bits.data(), bytes);
+        return;
+    }
+
+    for (size_t i = 0; i < bytes; i++)
+    {
+        destination[i] |= bits[i] << shift;
+        destination[i + 1] |= bits[i] >> (8 - shift);
+    }
+}
+
+template <typename Matches, typename PackedScan>
+int ParquetHybridDecoder::scan_runs(Matches matches, PackedScan packed_scan, std::vector<uint8_t>& output) const
+{
+    std::fill(output.begin(), output.begin() + (value_count + 7) / 8, 0);
+
+    // bitmap of a bit-packed run, runs don't necessarily start at a byte boundary of the output
+    std::vector<uint8_t> bitmap;
+
+    int hits = 0;
+    for (Run const& run : runs)
+    {
+        if (run.packed)
+        {
+            bitmap.resize(scan_output_buffer_size(run.count));
+            hits += packed_scan(run, bitmap);
+            __merge_bits(bitmap, run.count, output, run.begin);
+        }
+        else if (matches(run.value))
+        {
+            set_bits(output, run.begin, run.begin + run.count);
+            hits += (int)run.count;
+        }
+    }
+
+    return hits;
+}
+
+int ParquetHybridDecoder::scan_equal(uint32_t value, std::vector<uint8_t>& output) const
+{
+    return scan_runs([=](uint32_t x) { return x == value; }, [&](Run const& run, std::vector<uint8_t>& bitmap)
+    {
+        return scan(value, (__m128i*)run.data, run.count, bit_width, bitmap);
+    }, output);
+}
+
+int ParquetHybridDecoder::scan_between(uint32_t low, uint32_t high, std::vector<uint8_t>& output) const
+{
+    return scan_runs([=](uint32_t x) { return low <= x && x <= high; }, [&](Run const& run, std::vector<uint8_t>& bitmap)
+    {
+        return scan_range(low, high, (__m128i*)run.data, run.count, bit_width, bitmap);
+    }, output);
+}
+
+size_t ParquetHybridDecoder::size() const
+{
+    return value_count;
+}
+
+bool ParquetHybridDecoder::valid() const
+{
+    return is_valid;
+}
+
+size_t ParquetHybridDecoder::get_bit_width() const
+{
+    return bit_width;
+}
+
+size_t ParquetHybridDecoder::get_run_count() const
+{
+    return runs.size();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/*
+* Decoder for the Parquet RLE/bit-packing hybrid encoding (dictionary indices, repetition and
+* definition levels), bit widths 0-32
+*
+* The encoded data is a sequence of runs, each starting with a ULEB128 header:
+*   header & 1 == 0: RLE run of header >> 1 repetitions of a value in ceil(bit_width / 8) bytes
+*   header & 1 == 1: bit-packed run of (header >> 1) * 8 values, packed LSB first
+* The bit-packed runs use the layout of compress_input, so they are decompressed and scanned in
+* place by the width dispatched kernels, RLE runs are written as a whole. The decoder doesn't own
+* the page, it only keeps an index of the runs. Bit-packed runs that end too close to the end of
+* the page for the SIMD loads are copied into a padded buffer once.
+*
+* Pages are untrusted input: a malformed page or an unsupported bit width leaves the decoder empty
+* and valid() returns false.
+*/
+
+class ParquetHybridDecoder
+{
+private:
+    struct Run
+    {
+        size_t begin; // index of the first value
+        size_t count;
+        bool packed;
+        uint32_t value; // RLE runs
+        const uint8_t* data; // bit-packed runs
+    };
+
+    size_t bit_width;
+    size_t value_count;
+    bool is_valid;
+    std::vector<Run> runs;
+    std::unique_ptr<uint64_t[]> tail; // padded copy of the runs at the end of the page
+
+    bool parse(const uint8_t* data, size_t size);
+
+    // matches(value) decides RLE runs, packed_scan(run, bitmap) scans bit-packed runs
+    template <typename Matches, typename PackedScan>
+    int scan_runs(Matches matches, PackedScan packed_scan, std::vector<uint8_t>& output) const;
+
+public:
+    // value_count is the number of values of the page, the last bit-packed run may be padded
+    ParquetHybridDecoder(const uint8_t* data, size_t size, size_t bit_width, size_t value_count);
+
+    // data page with dictionary indices (RLE_DICTIONARY): the bit width is stored in the first byte
+    static ParquetHybridDecoder dictionary_indices(const uint8_t* data, size_t size, size_t value_count);
+
+    // repetition/definition levels of a v1 data page: the length is stored in the first 4 bytes
+    static ParquetHybridDecoder levels(const uint8_t* data, size_t size, size_t bit_width, size_t value_count);
+
+    // output sized with decompression_output_buffer_size(size())
+    void decode(int* output) const;
+
+    int scan_equal(uint32_t value, std::vector<uint8_t>& output) const;
+
+    // low <= value <= high
+    int scan_between(uint32_t low, uint32_t high, std::vector<uint8_t>& output) const;
+
+    size_t size() const;
+
+    bool valid() const;
+
+    size_t get_bit_width() const;
+
+    size_t get_run_count() const;
+};
@@ -0,0 +1,156 @@
+#include <algorithm>
+
+#include "patched_frame_of_reference_column.hpp"
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+// an exception costs its position and its full offset
+static const size_t exception_bits = 8 * (sizeof(uint32_t) + sizeof(uint64_t));
+
+PatchedFrameOfReferenceColumn::PatchedFrameOfReferenceColumn(std::vector<int64_t> const& values)
+    : base(0), compression(1), element_count(values.size())
+{
+    if (values.size() > UINT32_MAX)
+    {
+        std::cerr << "patched frame of reference supports up to " << UINT32_MAX << " values!" << std::endl;
+        element_count = 0;
+    }
+
+    if (element_count > 0)
+    {
+        base = *std::min_element(values.begin(), values.end());
+    }
+
+    // number of offsets per minimal width, the exceptions of a width are the offsets that need more bits
+    std::vector<size_t> width_histogram(65);
+    for (size_t i = 0; i < element_count; i++)
+    {
+        width_histogram[bits_needed(uint64_t(values[i]) - uint64_t(base))]++;
+    }
+
+    size_t exceptions = element_count - width_histogram[1];
+    size_t best_size = element_count + exceptions * exception_bits;
+    for (size_t bits = 2; bits <= 32; bits++)
+    {
+        exceptions -= width_histogram[bits];
+        size_t size = element_count * bits + exceptions * exception_bits;
+        if (size < best_size)
+        {
+            best_size = size;
+            compression = bits;
+        }
+    }
+
+    std::vector<uint32_t> codes(element_count);
+    for (size_t i = 0; i < element_count; i++)
+    {
+        uint64_t offset = uint64_t(values[i]) - uint64_t(base);
+        codes[i] = (uint32_t)(offset & code_mask(compression));
+
+        if (offset > code_mask(compression))
+        {
+            exception_positions.push_back((uint32_t)i);
+            exception_offsets.push_back(offset);
+        }
+    }
+
+    buffer = compress_128(codes, compression);
+}
+
+template <typename Predicate>
+int PatchedFrameOfReferenceColumn::patch_exceptions(Predicate predicate, std::vector<uint8_t>& output) const
+{
+    int hits = 0;
+    for (size_t i = 0; i < exception_positions.size(); i++)
+    {
+        bool match = predicate(exception_offsets[i]);
+        hits += (int)match - (int)get_bit(output, exception_positions[i]);
+        set_bit(output, exception_positions[i], match);
+    }
+    return hits;
+}
+
+void PatchedFrameOfReferenceColumn::decompress(int64_t* output) const
+{
+    decompress_for(data(), element_count, compression, base, output);
+
+    for (size_t i = 0; i < exception_positions.size(); i++)
+    {
+        output[exception_positions[i]] = (int64_t)(uint64_t(base) + exception_offsets[i]);
+    }
+}
+
+int PatchedFrameOfReferenceColumn::scan_equal(int64_t value, std::vector<uint8_t>& output) const
+{
+    uint64_t offset = uint64_t(value) - uint64_t(base);
+
+    int hits = 0;
+    if (value < base || offset > code_mask(compression))
+    {
+        // only exceptions can match
+        std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+    }
+    else
+    {
+        hits = scan((int)offset, data(), element_count, compression, output);
+    }
+
+    return hits + patch_exceptions([=](uint64_t x) { return value >= base && x == offset; }, output);
+}
+
+int PatchedFrameOfReferenceColumn::scan_between(int64_t low, int64_t high, std::vector<uint8_t>& output) const
+{
+    if (high < base || low > high)
+    {
+        std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+        return 0;
+    }
+
+    uint64_t offset_low = low > base ? uint64_t(low) - uint64_t(base) : 0;
+    uint64_t offset_high = uint64_t(high) - uint64_t(base);
+
+    int hits = 0;
+    if (offset_low > code_mask(compression))
+    {
+        // only exceptions can match
+        std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+    }
+    else
+    {
+        uint32_t code_high = (uint32_t)std::min<uint64_t>(offset_high, code_mask(compression));
+        hits = scan_range((uint32_t)offset_low, code_high, data(), element_count, compression, output);
+    }
+
+    return hits + patch_exceptions([=](uint64_t x) { return offset_low <= x && x <= offset_high; }, output);
+}
+
+size_t PatchedFrameOfReferenceColumn::size() const
+{
+    return element_count;
+}
+
+int64_t PatchedFrameOfReferenceColumn::get_base() const
+{
+    return base;
+}
+
+size_t PatchedFrameOfReferenceColumn::get_compression() const
+{
+    return compression;
+}
+
+size_t PatchedFrameOfReferenceColumn::get_exception_count() const
+{
+    return exception_positions.size();
+}
+
+size_t PatchedFrameOfReferenceColumn::compressed_size() const
+{
+    return compressed_buffer_size(compression, element_count) + exception_bits / 8 * exception_positions.size();
+}
+
+__m128i* PatchedFrameOfReferenceColumn::data() const
+{
+    return (__m128i*)buffer.get();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <immintrin.h>
+#include <memory>
+#include <vector>
+
+/*
+* Patched frame of reference (PFOR) encoded column
+*
+* Like the frame of reference column, value - base is packed, but with the width that minimizes
+* the total size rather than the width of the largest value. Values that don't fit are exceptions:
+* their slot only holds the low bits and their position and full offset are kept in an exception
+* list. Scans and decompression run the width dispatched SIMD kernels over the whole column and
+* patch the exceptions in afterwards, so the spread of the values may use all 64 bits.
+*/
+
+class PatchedFrameOfReferenceColumn
+{
+private:
+    int64_t base;
+    size_t compression;
+    size_t element_count;
+    std::unique_ptr<uint64_t[]> buffer;
+    std::vector<uint32_t> exception_positions;
+    std::vector<uint64_t> exception_offsets; // value - base
+
+    // overwrites the bits of the exceptions with the predicate on their offset, returns the change in hits
+    template <typename Predicate>
+    int patch_exceptions(Predicate predicate, std::vector<uint8_t>& output) const;
+
+public:
+    PatchedFrameOfReferenceColumn(std::vector<int64_t> const& values);
+
+    // output sized with decompression_output_buffer_size(size(), sizeof(int64_t))
+    void decompress(int64_t* output) const;
+
+    int scan_equal(int64_t value, std::vector<uint8_t>& output) const;
+
+    // low <= value <= high
+    int scan_between(int64_t low, int64_t high, std::vector<uint8_t>& output) const;
+
+    size_t size() const;
+
+    int64_t get_base() const;
+
+    size_t get_compression() const;
+
+    size_t get_exception_count() const;
+
+    // bytes of the packed buffer and the exception list
+    size_t compressed_size() const;
+
+    __m128i* data() const;
+};
@@ -0,0 +1,106 @@
+#include <algorithm>
+
+#include "run_length_column.hpp"
+#include "simd_scan.hpp"
+#include "util.hpp"
+
+RunLengthColumn::RunLengthColumn(std::vector<uint32_t> const& column)
+    : element_count(column.size())
+{
+    std::vector<uint32_t> run_values;
+    std::vector<uint32_t> run_lengths;
+
+    for (size_t i = 0; i < column.size(); )
+    {
+        size_t end = i + 1;
+        while (end < column.size() && column[end] == column[i] && end - i <= UINT32_MAX) end++;
+
+        run_values.push_back(column[i]);
+        run_lengths.push_back((uint32_t)(end - i - 1));
+        i = end;
+    }
+
+    run_count = run_values.size();
+    value_compression = bits_needed(run_values.empty() ? 0 : *std::max_element(run_values.begin(), run_values.end()));
+    length_compression = bits_needed(run_lengths.empty() ? 0 : *std::max_element(run_lengths.begin(), run_lengths.end()));
+
+    values = compress_128(run_values, value_compression);
+    lengths = compress_128(run_lengths, length_compression);
+}
+
+std::vector<int> RunLengthColumn::decompress_lengths() const
+{
+    std::vector<int> run_lengths(decompression_output_buffer_size(run_count) / sizeof(int));
+    ::decompress((__m128i*)lengths.get(), run_count, length_compression, run_lengths.data());
+    return run_lengths;
+}
+
+void RunLengthColumn::decompress(int* output) const
+{
+    std::vector<int> run_values(decompression_output_buffer_size(run_count) / sizeof(int));
+    ::decompress((__m128i*)values.get(), run_count, value_compression, run_values.data());
+    std::vector<int> run_lengths = decompress_lengths();
+
+    for (size_t run = 0; run < run_count; run++)
+    {
+        size_t length = (uint32_t)run_lengths[run] + size_t(1);
+        std::fill(output, output + length, run_values[run]);
+        output += length;
+    }
+}
+
+int RunLengthColumn::emit_runs(std::vector<uint8_t> const& run_matches, std::vector<uint8_t>& output) const
+{
+    std::fill(output.begin(), output.begin() + (element_count + 7) / 8, 0);
+
+    std::vector<int> run_lengths = decompress_lengths();
+
+    int hits = 0;
+    size_t position = 0;
+    for (size_t run = 0; run < run_count; run++)
+    {
+        size_t length = (uint32_t)run_lengths[run] + size_t(1);
+        if (get_bit(run_matches, run))
+        {
+            set_bits(output, position, position + length);
+            hits += (int)length;
+        }
+        position += length;
+    }
+
+    return hits;
+}
+
+int RunLengthColumn::scan_equal(uint32_t value, std::vector<uint8_t>& output) const
+{
+    std::vector<uint8_t> run_matches(scan_output_buffer_size(run_count));
+    scan(value, (__m128i*)values.get(), run_count, value_compression, run_matches);
+    return emit_runs(run_matches, output);
+}
+
+int RunLengthColumn::scan_between(uint32_t low, uint32_t high, std::vector<uint8_t>& output) const
+{
+    std::vector<uint8_t> run_matches(scan_output_buffer_size(run_count));
+    scan_range(low, high, (__m128i*)values.get(), run_count, value_compression, run_matches);
+    return emit_runs(run_matches, output);
+}
+
+size_t RunLengthColumn::size() const
+{
+    return element_count;
+}
+
+size_t RunLengthColumn::get_run_count() const
+{
+    return run_count;
+}
+
+size_t RunLengthColumn::get_value_compression() const
+{
+    return value_compression;
+}
+
+size_t RunLengthColumn::get_length_compression() const
+{
+    return length_compression;
+}
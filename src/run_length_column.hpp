@@ -0,0 +1,49 @@
+#pragma once
+
+#include <immintrin.h>
+#include <memory>
+#include <vector>
+
+/*
+* Run length encoded column (values up to 32 bits)
+*
+* The value and the length - 1 of each run are packed into two separate buffers with their own
+* minimal widths. Scans evaluate the predicate once per run with the SIMD kernels on the packed
+* run values and then write whole runs into the output bitmap, so their cost depends on the number
+* of runs rather than the number of elements (apart from clearing the output).
+*/
+
+class RunLengthColumn
+{
+private:
+    size_t element_count;
+    size_t run_count;
+    size_t value_compression;
+    size_t length_compression;
+    std::unique_ptr<uint64_t[]> values;
+    std::unique_ptr<uint64_t[]> lengths;
+
+    // sets the bits of the runs that are set in run_matches
+    int emit_runs(std::vector<uint8_t> const& run_matches, std::vector<uint8_t>& output) const;
+
+    std::vector<int> decompress_lengths() const;
+
+public:
+    RunLengthColumn(std::vector<uint32_t> const& column);
+
+    // output sized with decompression_output_buffer_size(size())
+    void decompress(int* output) const;
+
+    int scan_equal(uint32_t value, std::vector<uint8_t>& output) const;
+
+    // low <= value <= high
+    int scan_between(uint32_t low, uint32_t high, std::vector<uint8_t>& output) const;
+
+    size_t size() const;
+
+    size_t get_run_count() const;
+
+    size_t get_value_compression() const;
+
+    size_t get_length_compression() const;
+};
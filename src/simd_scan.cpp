@@ -17,19 +17,21 @@
 #include "util.hpp"
 #include "simd_scan_commons.hpp"
 
-int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
+int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
 {
     uint64_t* in = reinterpret_cast<uint64_t*>(input);
-    auto bits_needed = BITS_NEEDED;
+    auto bits_needed = compression;
     auto mem_size = bits_needed * input_size;
-    int array_size = ceil((double)mem_size / 64);
+    size_t array_size = ceil((double)mem_size / 64);
 
-    uint64_t mask = (1 << bits_needed) - 1;
+    uint64_t mask = (uint64_t(1) << bits_needed) - 1;
+    uint32_t key = predicate_key;
 
     uint64_t current = 0;
     size_t overflow_bits = 0;
 
     size_t oi = 0;
+    size_t processed = 0; // number of elements compared
 
     int hits = 0;
 
@@ -43,8 +45,8 @@ int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std:
         size_t unread_bits = 64 - overflow_bits;
         while (unread_bits >= bits_needed)
         {
-            uint16_t decompressed_element = current & mask;
-            bool match = decompressed_element == predicate_key;
+            uint32_t decompressed_element = current & mask;
+            bool match = decompressed_element == key;
             output_byte |= match << (out_bits_used++);
 
             if (out_bits_used == 8)
@@ -55,9 +57,9 @@ int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std:
                 out_bits_used = 0;
             }
 
-            if (oi == input_size)
+            if (++processed == input_size)
             {
-                return hits;
+                goto finish;
             }
 
             current = current >> bits_needed;
@@ -70,8 +72,8 @@ int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std:
             uint64_t next = in[i + 1];
             current = current | (next << unread_bits);
 
-            uint16_t decompressed_element = current & mask;
-            bool match = decompressed_element == predicate_key;
+            uint32_t decompressed_element = current & mask;
+            bool match = decompressed_element == key;
             output_byte |= match << (out_bits_used++);
 
             if (out_bits_used == 8)
@@ -82,6 +84,11 @@ int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std:
                 out_bits_used = 0;
             }
 
+            if (++processed == input_size)
+            {
+                goto finish;
+            }
+
             overflow_bits = bits_needed - unread_bits;
         }
         else
@@ -90,6 +97,7 @@ int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std:
         }
     }
 
+finish:
     if (out_bits_used != 0) 
     {
         output[oi] = output_byte;
@@ -100,12 +108,10 @@ int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std:
 }
 
 // based on decompress_128_unrolled
-int scan_128(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
+int scan_128(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
 {
     int hits = 0;
 
-    size_t compression = BITS_NEEDED;
-
     __m128i source = _mm_loadu_si128(input);
 
     size_t output_index = 0; // current write index of the output array
@@ -157,6 +163,60 @@ int scan_128(int predicate_key, __m128i* input, size_t input_size, std::vector<u
     return hits;
 }
 
+// for elements that don't fit the 4 byte shuffle window (compression up to 32)
+int scan_128_wide(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    int hits = 0;
+
+    __m128i source = _mm_loadu_si128(input);
+
+    size_t output_index = 0; // current write index of the output array
+
+    __m128i shuffle_mask_low[2], shuffle_mask_high[2];
+    generate_wide_shuffle_masks_128(compression, shuffle_mask_low, shuffle_mask_high);
+
+    __m128i shift_mask[2];
+    generate_wide_shift_masks_128(compression, shift_mask);
+
+    __m128i and_mask = _mm_set1_epi32(code_mask(compression));
+    __m128i predicate = _mm_set1_epi32(predicate_key);
+
+    while (8 * output_index < input_size)
+    {
+        uint8_t out = 0;
+
+        {
+            size_t mask_index = 0;
+            __m128i d = unpack_wide_128(source, shuffle_mask_low[mask_index], shuffle_mask_high[mask_index], shift_mask[mask_index], and_mask);
+            __m128i e = _mm_cmpeq_epi32(d, predicate);
+
+            out |= _mm_movemask_ps(_mm_castsi128_ps(e));
+
+            // load next
+            size_t total_processed_bytes = (8 * output_index + 4) * compression / 8;
+            source = _mm_loadu_si128((__m128i*)&((uint8_t*)input)[total_processed_bytes]);
+        }
+
+        {
+            size_t mask_index = 1;
+            __m128i d = unpack_wide_128(source, shuffle_mask_low[mask_index], shuffle_mask_high[mask_index], shift_mask[mask_index], and_mask);
+            __m128i e = _mm_cmpeq_epi32(d, predicate);
+
+            out |= (_mm_movemask_ps(_mm_castsi128_ps(e)) << 4);
+
+            // load next
+            size_t total_processed_bytes = (8 * output_index + 8) * compression / 8;
+            source = _mm_loadu_si128((__m128i*)&((uint8_t*)input)[total_processed_bytes]);
+        }
+
+        output[output_index] = out;
+        output_index += 1;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
 inline void __scan_128_step(uint32_t& out, size_t const& offset, __m128i const& shuffle_mask, 
     __m128i const& clean_mask, __m128i const& predicate, size_t const& output_index, size_t const& compression, 
     __m128i* input, __m128i& source)
@@ -172,12 +232,10 @@ inline void __scan_128_step(uint32_t& out, size_t const& offset, __m128i const&
     source = _mm_loadu_si128((__m128i*)&((uint8_t*)input)[total_processed_bytes]);
 }
 
-int scan_128_unrolled(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
+int scan_128_unrolled(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
 {
     int hits = 0;
 
-    size_t compression = BITS_NEEDED;
-
     __m128i source = _mm_loadu_si128(input);
 
     uint32_t* output_array = reinterpret_cast<uint32_t*>(output.data());
@@ -215,94 +273,3 @@ int scan_128_unrolled(int predicate_key, __m128i* input, size_t input_size, std:
 
     return hits;
 }
-
-#ifdef __AVX__
-int scan_256(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
-{
-    int hits = 0;
-
-    size_t compression = BITS_NEEDED;
-
-    //avxi_t source = _mm256_loadu_si256(input);
-    __m256i source = _mm256_loadu2_m128i(input, input);
-
-    size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
-
-    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
-
-    __m256i clean_mask = generate_clean_mask_256(compression);
-
-    __m256i predicate = generate_predicate_mask_256(compression, predicate_key);
-
-    while (8 * output_index < input_size)
-    {
-        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
-        __m256i c = _mm256_and_si256(b, clean_mask);
-        __m256i e = _mm256_cmpeq_epi32(c, predicate);
-
-        int matches = _mm256_movemask_ps(_mm256_castsi256_ps(e));
-        hits += POPCNT(matches);
-        output[output_index] = matches;
-
-        // load next
-        output_index += 1;
-        size_t total_processed_bytes = (8 * output_index) * compression / 8;
-        __m128i* next = (__m128i*)&((uint8_t*)input)[total_processed_bytes];
-        source = _mm256_loadu2_m128i(next, next);
-    }
-
-    return hits;
-}
-
-inline void __scan_256_step(uint32_t& out, size_t const& offset, __m256i const& shuffle_mask,
-    __m256i const& clean_mask, __m256i const& predicate, size_t const& output_index, size_t const& compression,
-    __m128i* input, __m256i& source)
-{
-    __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
-    __m256i c = _mm256_and_si256(b, clean_mask);
-    __m256i e = _mm256_cmpeq_epi32(c, predicate);
-
-    out |= _mm256_movemask_ps(_mm256_castsi256_ps(e)) << offset;
-
-    // load next
-    size_t total_processed_bytes = (32 * output_index + offset + 8) * compression / 8;
-    __m128i* next = (__m128i*)&((uint8_t*)input)[total_processed_bytes];
-    source = _mm256_loadu2_m128i(next, next);
-}
-
-int scan_256_unrolled(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
-{
-    int hits = 0;
-
-    size_t compression = BITS_NEEDED;
-
-    //avxi_t source = _mm256_loadu_si256(input);
-    __m256i source = _mm256_loadu2_m128i(input, input);
-
-    uint32_t* output_array = reinterpret_cast<uint32_t*>(output.data());
-    size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
-
-    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
-
-    __m256i clean_mask = generate_clean_mask_256(compression);
-
-    __m256i predicate = generate_predicate_mask_256(compression, predicate_key);
-
-    while (32 * output_index < input_size)
-    {
-        uint32_t out = 0;
-
-        __scan_256_step(out,  0, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
-        __scan_256_step(out,  8, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
-        __scan_256_step(out, 16, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
-        __scan_256_step(out, 24, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
-
-        output_array[output_index] = out;
-        output_index += 1;
-        hits += POPCNT(out);
-    }
-
-    return hits;
-}
-#endif
-
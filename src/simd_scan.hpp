@@ -9,6 +9,7 @@
 
 #include "util.hpp"
 
+// default bit width used by the benchmarks and tests, all kernels take the width as a parameter
 #define BITS_NEEDED 9
 
 /*
@@ -25,10 +26,10 @@ constexpr size_t compressed_buffer_size(uint8_t compression, size_t input_array_
     return bytes + padding;
 }
 
-constexpr size_t decompression_output_buffer_size(size_t input_array_size)
+constexpr size_t decompression_output_buffer_size(size_t input_array_size, size_t element_size = sizeof(int))
 {
-    auto size = input_array_size * 4;
-    auto padding = 32;
+    auto size = input_array_size * element_size;
+    auto padding = 64; // the 256 bit kernels write up to two registers past the end
     return size + padding;
 }
 
@@ -41,35 +42,64 @@ constexpr size_t scan_output_buffer_size(size_t input_array_size)
 
 /* 
 * Compression
+*
+* compress_input packs each element of the input into compression (1-32, 1-64 for uint64_t input) bits,
+* the element at index i occupies the bits [i * compression, (i + 1) * compression) of the little endian
+* output stream.
 */
 
 std::unique_ptr<uint64_t[]> compress_9bit_input(std::vector<uint16_t>& input);
 
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_input(std::vector<T> const& input, size_t compression);
+
+// SIMD version of compress_input (SSE4.1, compression 1-32), produces the same bytes
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_128(std::vector<T> const& input, size_t compression);
+
+// packs into an existing buffer, output has to be at a byte boundary of the stream and is followed
+// by at least 32 writable bytes (overwritten with zeros)
+template <typename T>
+void compress_128_into(T const* input, size_t input_size, size_t compression, uint8_t* output);
+
+// compress_128 on all cores (OpenMP), the input is split into chunks that start at byte boundaries
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_128_parallel(std::vector<T> const& input, size_t compression);
+
 /*
-* Non-vectorized decompression
+* Non-vectorized decompression (compression 1-32)
 */
-void decompress_unvectorized(__m128i* input, size_t input_size, int* output);
+void decompress_unvectorized(__m128i* input, size_t input_size, size_t compression, int* output);
 
 /*
 * SIMD decompression (SSE3; 128bit)
+*
+* The shuffle based kernels require each element to fit into a 4 byte window (see fits_shuffle_window),
+* i.e. they support compression 1-26, 28 and 32. The *_wide kernels cover the remaining widths.
 */
-void decompress_128_sweep(__m128i* input, size_t input_size, int* output);
-void decompress_128_nosweep(__m128i* input, size_t input_size, int* output);
+void decompress_128_sweep(__m128i* input, size_t input_size, size_t compression, int* output);
+void decompress_128_nosweep(__m128i* input, size_t input_size, size_t compression, int* output);
 void decompress_128_9bit(__m128i* input, size_t input_size, int* output);
-void decompress_128(__m128i* input, size_t input_size, int* output);
-void decompress_128_unrolled(__m128i* input, size_t input_size, int* output);
-void decompress_128_aligned(__m128i* input, size_t input_size, int* output);
+void decompress_128(__m128i* input, size_t input_size, size_t compression, int* output);
+void decompress_128_unrolled(__m128i* input, size_t input_size, size_t compression, int* output);
+void decompress_128_aligned(__m128i* input, size_t input_size, size_t compression, int* output);
+
+// assembles each element from two shuffles, supports compression 1-32
+void decompress_128_wide(__m128i* input, size_t input_size, size_t compression, int* output);
 
 /*
-* SIMD decompression (AVX and AVX2; 256bit)
+* SIMD decompression (AVX2; 256bit)
+*
+* All 256 bit kernels live in the *_avx2.cpp translation units, which are the only ones compiled with
+* AVX2 enabled. They are declared if the build includes them (ENABLE_AVX2), callers have to check
+* cpu_supports_avx2() before using them.
 */
 
-#ifdef __AVX__
-void decompress_256(__m128i* input, size_t input_size, int* output);
-#endif
-
-#ifdef __AVX2__
-void decompress_256_avx2(__m128i* input, size_t input_size, int* output);
+#if ENABLE_AVX2
+void decompress_256(__m128i* input, size_t input_size, size_t compression, int* output);
+void decompress_256_wide(__m128i* input, size_t input_size, size_t compression, int* output);
+void decompress_256_avx2(__m128i* input, size_t input_size, size_t compression, int* output);
+void decompress_256_permute(__m128i* input, size_t input_size, size_t compression, int* output);
 #endif
 
 /*
@@ -86,46 +116,262 @@ void decompress_256_avx2(__m128i* input, size_t input_size, int* output);
 /*
 * SIMD scan 
 */
-int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output);
-int scan_128(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output);
-int scan_128_unrolled(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output);
-
-#ifdef __AVX__
-int scan_256(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output);
-int scan_256_unrolled(int predicate_key, __m128i* input, size_t input_size, std::vector<uint8_t>& output);
+int scan_unvectorized(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_128(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_128_unrolled(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_128_wide(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+#if ENABLE_AVX2
+int scan_256(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_256_unrolled(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_256_wide(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_256_permute(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
 #endif
 
 /*
 * Shared SIMD scan
 */
 
-void shared_scan_128_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_128_sequential_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_128_threaded(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_128_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_128_standard_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_128_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_128_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_128_sequential_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_128_threaded(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_128_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_128_standard_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_128_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+
+#if ENABLE_AVX2
+void shared_scan_256_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_256_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_256_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+void shared_scan_256_permute(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+#endif
+
+/*
+* 16 bit lanes (compression 1-16), 8 elements per 128 bit compare
+*/
+
+int scan_128_16bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+void shared_scan_128_16bit(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+
+#if ENABLE_AVX2
+int scan_256_16bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+#endif
+
+/*
+* 8 bit lanes (compression 1-8), 16 elements per 128 bit compare
+*/
+
+int scan_128_8bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+#if ENABLE_AVX2
+int scan_256_8bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+#endif
+
+/*
+* Narrow output: uint16_t for compression 1-16, uint8_t for compression 1-8
+* (output buffers sized with decompression_output_buffer_size(input_size, sizeof(T)))
+*/
+
+void decompress_128_16bit(__m128i* input, size_t input_size, size_t compression, uint16_t* output);
+void decompress_128_8bit(__m128i* input, size_t input_size, size_t compression, uint8_t* output);
 
-#ifdef __AVX__
-void shared_scan_256_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_256_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
-void shared_scan_256_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs);
+#if ENABLE_AVX2
+void decompress_256_16bit(__m128i* input, size_t input_size, size_t compression, uint16_t* output);
+void decompress_256_8bit(__m128i* input, size_t input_size, size_t compression, uint8_t* output);
 #endif
 
+/*
+* 64 bit elements (compression 1-64, meant for 33-64), decompressed to uint64_t
+*/
+
+void decompress_unvectorized_64bit(__m128i* input, size_t input_size, size_t compression, uint64_t* output);
+int scan_unvectorized_64bit(uint64_t predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+// predicate_low <= element <= predicate_high
+int scan_range_unvectorized_64bit(uint64_t predicate_low, uint64_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+#if ENABLE_AVX2
+void decompress_256_64bit(__m128i* input, size_t input_size, size_t compression, uint64_t* output);
+void decompress_for_256_64bit(__m128i* input, size_t input_size, size_t compression, int64_t base, int64_t* output);
+int scan_256_64bit(uint64_t predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_range_256_64bit(uint64_t predicate_low, uint64_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+#endif
+
+// pick the 256bit kernels if the cpu supports AVX2, nothing is written past input_size elements
+void decompress_64bit(__m128i* input, size_t input_size, size_t compression, uint64_t* output);
+void decompress_for_64bit(__m128i* input, size_t input_size, size_t compression, int64_t base, int64_t* output);
+int scan_64bit(uint64_t predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_range_64bit(uint64_t predicate_low, uint64_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+/*
+* Scalar kernels (BMI2; pdep/pext), compression 1-32
+*
+* They live in simd_scan_bmi2.cpp, which is the only translation unit compiled with BMI2 enabled.
+* Declared if the build includes them (ENABLE_BMI2), callers have to check cpu_supports_bmi2().
+* Like the width dispatched kernels they handle partial blocks exactly. The *_tail_bmi2 variants
+* process the elements [begin, end) (begin must be a multiple of 8) and are used as tail handlers
+* by the SIMD kernels.
+*/
+
+#if ENABLE_BMI2
+void decompress_bmi2(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan_bmi2(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+void decompress_tail_bmi2(const uint8_t* input, size_t begin, size_t end, size_t compression, int* output);
+int scan_tail_bmi2(uint32_t predicate_key, const uint8_t* input, size_t begin, size_t end, size_t compression, uint8_t* output);
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_input_bmi2(std::vector<T> const& input, size_t compression);
+#endif
+
+/*
+* Width dispatched kernels
+*
+* Pick a kernel that is specialized for the given bit width (1-32) at compile time. Unlike the
+* kernels above they handle partial blocks exactly, i.e. they don't write past input_size elements
+* or set bits for elements past input_size. If the cpu supports AVX2 the 256bit permute kernels are
+* used instead where possible (checked once at startup).
+*/
+
+void decompress(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+void shared_scan(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs);
+
+// predicate_low <= element <= predicate_high (unsigned)
+int scan_range(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+// frame of reference: output[i] = base + element i
+void decompress_for(__m128i* input, size_t input_size, size_t compression, int64_t base, int64_t* output);
+
+// delta decoding of the elements [begin, end): output[i - begin] = start + sum of the elements [begin, i],
+// begin has to be a multiple of 32
+void decompress_delta(__m128i* input, size_t begin, size_t end, size_t compression, int64_t start, int64_t* output);
+
+/*
+* Vertical layout (SIMD-BP128 style), compression 1-32
+*
+* An alternative to the packed layout of compress_input: the elements are stored in blocks of
+* vertical_block_size elements, element i of a block goes to the 32bit lane i % 8 of 256bit words
+* and every lane packs its elements back to back (LSB first). A block spans compression 256bit
+* words, so 8 consecutive elements are always at the same bit position of all lanes and the
+* kernels only need aligned loads, fixed shifts and masks instead of shuffles and multiplies.
+* The 128bit kernels process the lanes 0-3 and 4-7 separately, so both use the same buffer.
+*
+* Like the width dispatched kernels they handle partial blocks exactly. decompress_vertical and
+* scan_vertical pick the 256bit kernels if the cpu supports AVX2.
+*/
+
+constexpr size_t vertical_block_size = 256;
+
+size_t vertical_buffer_size(size_t compression, size_t input_size);
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_vertical(std::vector<T> const& input, size_t compression);
+
+void decompress_vertical_128(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan_vertical_128(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+#if ENABLE_AVX2
+void decompress_vertical_256(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan_vertical_256(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+#endif
+
+void decompress_vertical(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan_vertical(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+/*
+* BitWeaving/H layout, compression 1-32
+*
+* Every code is padded with a zero delimiter bit and never crosses a 64bit word, a word holds
+* 64 / (compression + 1) codes. The scans evaluate the predicate on all codes of a word at once
+* with additions and xors (SWAR) and never unpack the codes. Partial segments are handled exactly.
+* decompress_bitweaving_h is a scalar conversion back to integers.
+*/
+
+size_t bitweaving_h_buffer_size(size_t compression, size_t input_size);
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_bitweaving_h(std::vector<T> const& input, size_t compression);
+
+void decompress_bitweaving_h(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan_bitweaving_h(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+// predicate_low <= element <= predicate_high (unsigned), e.g. element < key is [0, key - 1]
+int scan_range_bitweaving_h(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+/*
+* BitWeaving/V layout (bit sliced), compression 1-32
+*
+* Segments of 128 codes are stored as compression 128bit slices, slice j holds bit
+* compression - 1 - j of every code. The scans process the slices from the most significant bit
+* down and skip the rest of a segment as soon as all of its codes are decided, so selective
+* predicates on wide codes read only a part of the buffer. Partial segments are handled exactly.
+* bitweaving_v_from_packed/bitweaving_v_to_packed convert from/to the layout of compress_input.
+*/
+
+size_t bitweaving_v_buffer_size(size_t compression, size_t input_size);
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_bitweaving_v(std::vector<T> const& input, size_t compression);
+
+std::unique_ptr<uint64_t[]> bitweaving_v_from_packed(__m128i* input, size_t input_size, size_t compression);
+std::unique_ptr<uint64_t[]> bitweaving_v_to_packed(__m128i* input, size_t input_size, size_t compression);
+
+void decompress_bitweaving_v(__m128i* input, size_t input_size, size_t compression, int* output);
+int scan_bitweaving_v(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+// predicate_low <= element <= predicate_high (unsigned)
+int scan_range_bitweaving_v(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+/*
+* ByteSlice layout, compression 1-32
+*
+* Segments of byteslice_segment_size codes are stored as byteslice_slices(compression) slices
+* of 32 bytes, slice k holds the byte k of every code (most significant byte first). The scans
+* compare one byte slice at a time and skip the remaining slices of a segment once all of its
+* codes are decided. Partial segments are handled exactly. scan_byteslice/scan_range_byteslice
+* pick the 256bit kernels if the cpu supports AVX2.
+*/
+
+constexpr size_t byteslice_segment_size = 32;
+
+constexpr size_t byteslice_slices(size_t compression)
+{
+    return (compression + 7) / 8;
+}
+
+size_t byteslice_buffer_size(size_t compression, size_t input_size);
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_byteslice(std::vector<T> const& input, size_t compression);
+
+void decompress_byteslice(__m128i* input, size_t input_size, size_t compression, int* output);
+
+int scan_byteslice_128(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_range_byteslice_128(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+#if ENABLE_AVX2
+int scan_byteslice_256(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+int scan_range_byteslice_256(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+#endif
+
+int scan_byteslice(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
+// predicate_low <= element <= predicate_high (unsigned)
+int scan_range_byteslice(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
+
 /*
 * Shared SIMD scan with one linear output vector
 */
 
-void shared_scan_128_linear_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<uint8_t>& outputs);
-void shared_scan_128_linear_simple(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<uint8_t>& output);
+void shared_scan_128_linear_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& outputs);
+void shared_scan_128_linear_simple(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output);
 
 template <size_t NUM>
-void shared_scan_128_linear_static(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
+void shared_scan_128_linear_static(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
 {
     uint8_t* output_d = output.data();
 
-    size_t compression = BITS_NEEDED;
-
     __m128i source = _mm_loadu_si128(input);
 
     size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
@@ -162,16 +408,17 @@ void shared_scan_128_linear_static(std::vector<int> const& predicate_keys, __m12
     }
 
     __m128i clean_mask[2];
+    uint32_t mask = compression >= 32 ? 0xFFFFFFFFu : (uint32_t(1) << compression) - 1;
     clean_mask[0] = _mm_setr_epi32(
-        ((1 << compression) - 1) << padding[0],
-        ((1 << compression) - 1) << padding[1],
-        ((1 << compression) - 1) << padding[2],
-        ((1 << compression) - 1) << padding[3]);
+        mask << padding[0],
+        mask << padding[1],
+        mask << padding[2],
+        mask << padding[3]);
     clean_mask[1] = _mm_setr_epi32(
-        ((1 << compression) - 1) << padding[4],
-        ((1 << compression) - 1) << padding[5],
-        ((1 << compression) - 1) << padding[6],
-        ((1 << compression) - 1) << padding[7]);
+        mask << padding[4],
+        mask << padding[5],
+        mask << padding[6],
+        mask << padding[7]);
 
     // registers for comparison predicate
     __m128i predicates[NUM*2];
@@ -179,15 +426,15 @@ void shared_scan_128_linear_static(std::vector<int> const& predicate_keys, __m12
     {
         const int& predicate_key = predicate_keys[i];
         predicates[i*2] = _mm_setr_epi32(
-            predicate_key << padding[0],
-            predicate_key << padding[1],
-            predicate_key << padding[2],
-            predicate_key << padding[3]);
+            uint32_t(predicate_key) << padding[0],
+            uint32_t(predicate_key) << padding[1],
+            uint32_t(predicate_key) << padding[2],
+            uint32_t(predicate_key) << padding[3]);
         predicates[i*2+1] = _mm_setr_epi32(
-            predicate_key << padding[4],
-            predicate_key << padding[5],
-            predicate_key << padding[6],
-            predicate_key << padding[7]);
+            uint32_t(predicate_key) << padding[4],
+            uint32_t(predicate_key) << padding[5],
+            uint32_t(predicate_key) << padding[6],
+            uint32_t(predicate_key) << padding[7]);
     }
     
     size_t oidx = 0;
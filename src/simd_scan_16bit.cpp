@@ -0,0 +1,51 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+// 16 bit lanes, see Masks16bit in simd_scan_commons.hpp
+
+int scan_128_16bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit masks(compression);
+    __m128i predicate = _mm_set1_epi16((int16_t)predicate_key);
+
+    int hits = 0;
+
+    for (size_t i = 0; i < input_size; i += 16)
+    {
+        __m128i e1 = _mm_cmpeq_epi16(unpack_16bit_128(_mm_loadu_si128((__m128i*)&in[i * compression / 8]), compression, masks), predicate);
+        __m128i e2 = _mm_cmpeq_epi16(unpack_16bit_128(_mm_loadu_si128((__m128i*)&in[(i + 8) * compression / 8]), compression, masks), predicate);
+
+        uint16_t out = _mm_movemask_epi8(_mm_packs_epi16(e1, e2));
+        memcpy(&output[i / 8], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+void shared_scan_128_16bit(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit masks(compression);
+
+    for (size_t i = 0; i < input_size; i += 16)
+    {
+        __m128i d1 = unpack_16bit_128(_mm_loadu_si128((__m128i*)&in[i * compression / 8]), compression, masks);
+        __m128i d2 = unpack_16bit_128(_mm_loadu_si128((__m128i*)&in[(i + 8) * compression / 8]), compression, masks);
+
+        for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+        {
+            __m128i predicate = _mm_set1_epi16((int16_t)predicate_keys[key_id]);
+            __m128i e1 = _mm_cmpeq_epi16(d1, predicate);
+            __m128i e2 = _mm_cmpeq_epi16(d2, predicate);
+
+            uint16_t out = _mm_movemask_epi8(_mm_packs_epi16(e1, e2));
+            memcpy(&outputs[key_id][i / 8], &out, sizeof(out));
+        }
+    }
+}
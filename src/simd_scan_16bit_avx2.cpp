@@ -0,0 +1,36 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+// 16 bit lanes, see Masks16bit in simd_scan_commons.hpp
+
+int scan_256_16bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit masks(compression);
+    __m256i predicate = _mm256_set1_epi16((int16_t)predicate_key);
+
+    int hits = 0;
+
+    for (size_t i = 0; i < input_size; i += 32)
+    {
+        uint8_t* group = &in[i * compression / 8];
+        __m256i s1 = _mm256_loadu2_m128i((__m128i*)&group[compression], (__m128i*)group);
+        __m256i s2 = _mm256_loadu2_m128i((__m128i*)&group[3 * compression], (__m128i*)&group[2 * compression]);
+
+        __m256i e1 = _mm256_cmpeq_epi16(unpack_16bit_256(s1, compression, masks), predicate);
+        __m256i e2 = _mm256_cmpeq_epi16(unpack_16bit_256(s2, compression, masks), predicate);
+
+        // packs works within 128 bit lanes: [e1 0-7, e2 0-7 | e1 8-15, e2 8-15]
+        __m256i e = _mm256_permute4x64_epi64(_mm256_packs_epi16(e1, e2), _MM_SHUFFLE(3, 1, 2, 0));
+
+        uint32_t out = _mm256_movemask_epi8(e);
+        memcpy(&output[i / 8], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
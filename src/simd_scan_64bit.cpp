@@ -0,0 +1,121 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+void decompress_unvectorized_64bit(__m128i* input, size_t input_size, size_t compression, uint64_t* output)
+{
+    uint8_t* in = (uint8_t*)input;
+
+    for (size_t i = 0; i < input_size; i++)
+    {
+        output[i] = extract_element_64(in, i, compression);
+    }
+}
+
+int scan_unvectorized_64bit(uint64_t predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    uint8_t* in = (uint8_t*)input;
+    int hits = 0;
+
+    for (size_t i = 0; i < input_size; i += 8)
+    {
+        uint8_t out = 0;
+        for (size_t j = 0; j < 8 && i + j < input_size; j++)
+        {
+            out |= (extract_element_64(in, i + j, compression) == predicate_key) << j;
+        }
+
+        output[i / 8] = out;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+int scan_range_unvectorized_64bit(uint64_t predicate_low, uint64_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    uint8_t* in = (uint8_t*)input;
+    int hits = 0;
+
+    for (size_t i = 0; i < input_size; i += 8)
+    {
+        uint8_t out = 0;
+        for (size_t j = 0; j < 8 && i + j < input_size; j++)
+        {
+            uint64_t element = extract_element_64(in, i + j, compression);
+            out |= (predicate_low <= element && element <= predicate_high) << j;
+        }
+
+        output[i / 8] = out;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+static const bool use_avx2 = ENABLE_AVX2 && cpu_supports_avx2();
+
+void decompress_64bit(__m128i* input, size_t input_size, size_t compression, uint64_t* output)
+{
+    size_t begin = 0;
+
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        // the 256bit kernel writes groups of 4 elements, the rest is extracted one by one
+        begin = input_size / 4 * 4;
+        decompress_256_64bit(input, begin, compression, output);
+    }
+#endif
+
+    for (size_t i = begin; i < input_size; i++)
+    {
+        output[i] = extract_element_64((uint8_t*)input, i, compression);
+    }
+}
+
+// frame of reference: output[i] = base + element i
+void decompress_for_64bit(__m128i* input, size_t input_size, size_t compression, int64_t base, int64_t* output)
+{
+    size_t begin = 0;
+
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        begin = input_size / 4 * 4;
+        decompress_for_256_64bit(input, begin, compression, base, output);
+    }
+#endif
+
+    for (size_t i = begin; i < input_size; i++)
+    {
+        output[i] = (int64_t)(extract_element_64((uint8_t*)input, i, compression) + uint64_t(base));
+    }
+}
+
+int scan_64bit(uint64_t predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        return scan_256_64bit(predicate_key, input, input_size, compression, output);
+    }
+#endif
+
+    return scan_unvectorized_64bit(predicate_key, input, input_size, compression, output);
+}
+
+int scan_range_64bit(uint64_t predicate_low, uint64_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        return scan_range_256_64bit(predicate_low, predicate_high, input, input_size, compression, output);
+    }
+#endif
+
+    return scan_range_unvectorized_64bit(predicate_low, predicate_high, input, input_size, compression, output);
+}
@@ -0,0 +1,182 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* Each 128 bit lane holds two elements in its 64 bit lanes. Elements that fit into 8 bytes including their
+* bit padding are gathered with one shuffle, the lower lane is loaded from the byte of element 0 and the
+* upper lane from the byte of element 2. The shuffle and shift masks repeat after 8 elements.
+* Other elements (e.g. 63 bit) can span 9 bytes, they are assembled from two gathers.
+*/
+class Unpack64bit
+{
+private:
+    uint8_t* input;
+    size_t compression;
+    bool use_shuffle;
+
+    __m256i shuffle_mask[2];
+    __m256i shift_mask[2];
+    __m256i and_mask;
+
+    __m256i lane_bit_offset; // gather path: bit offset of the 4 elements from the first one
+
+public:
+    Unpack64bit(__m128i* input, size_t compression)
+        : input((uint8_t*)input), compression(compression), use_shuffle(fits_shuffle_window_64(compression))
+    {
+        uint64_t mask = compression >= 64 ? ~uint64_t(0) : (uint64_t(1) << compression) - 1;
+        and_mask = _mm256_set1_epi64x(mask);
+
+        for (size_t mask_index = 0; mask_index < 2; mask_index++)
+        {
+            int8_t shuffle[32];
+            int64_t shift[4];
+
+            for (size_t lane = 0; lane < 2; lane++)
+            {
+                size_t first = 4 * mask_index + 2 * lane; // first element of the lane within 8 elements
+                size_t lane_offset = (first * compression) / 8;
+
+                for (size_t j = 0; j < 2; j++)
+                {
+                    size_t bit = (first + j) * compression;
+                    size_t input_offset = bit / 8 - lane_offset;
+
+                    for (size_t k = 0; k < 8; k++)
+                    {
+                        size_t index = input_offset + k;
+                        shuffle[16 * lane + 8 * j + k] = index < 16 ? index : -128;
+                    }
+                    shift[2 * lane + j] = bit % 8;
+                }
+            }
+
+            shuffle_mask[mask_index] = _mm256_loadu_si256((__m256i*)shuffle);
+            shift_mask[mask_index] = _mm256_loadu_si256((__m256i*)shift);
+        }
+
+        lane_bit_offset = _mm256_setr_epi64x(0, compression, 2 * compression, 3 * compression);
+    }
+
+    // returns the elements [index, index + 4), index has to be a multiple of 4
+    inline __m256i next(size_t index) const
+    {
+        if (use_shuffle)
+        {
+            size_t mask_index = index % 8 != 0;
+            __m256i source = _mm256_loadu2_m128i(
+                (__m128i*)&input[((index + 2) * compression) / 8],
+                (__m128i*)&input[(index * compression) / 8]);
+
+            __m256i b = _mm256_shuffle_epi8(source, shuffle_mask[mask_index]);
+            __m256i c = _mm256_srlv_epi64(b, shift_mask[mask_index]);
+            return _mm256_and_si256(c, and_mask);
+        }
+        else
+        {
+            __m256i bit_index = _mm256_add_epi64(_mm256_set1_epi64x(index * compression), lane_bit_offset);
+            __m256i byte_index = _mm256_srli_epi64(bit_index, 3);
+            __m256i padding = _mm256_and_si256(bit_index, _mm256_set1_epi64x(7));
+
+            __m256i low = _mm256_i64gather_epi64((long long const*)input, byte_index, 1);
+            __m256i high = _mm256_i64gather_epi64((long long const*)&input[8], byte_index, 1);
+
+            // a shift by 64 results in 0, so high doesn't contribute for elements without padding
+            __m256i c = _mm256_or_si256(
+                _mm256_srlv_epi64(low, padding),
+                _mm256_sllv_epi64(high, _mm256_sub_epi64(_mm256_set1_epi64x(64), padding)));
+
+            return _mm256_and_si256(c, and_mask);
+        }
+    }
+};
+
+void decompress_256_64bit(__m128i* input, size_t input_size, size_t compression, uint64_t* output)
+{
+    Unpack64bit unpack(input, compression);
+
+    for (size_t output_index = 0; output_index < input_size; output_index += 4)
+    {
+        _mm256_storeu_si256((__m256i*)&output[output_index], unpack.next(output_index));
+    }
+}
+
+void decompress_for_256_64bit(__m128i* input, size_t input_size, size_t compression, int64_t base, int64_t* output)
+{
+    Unpack64bit unpack(input, compression);
+    __m256i base_vector = _mm256_set1_epi64x(base);
+
+    // the addition wraps like the unsigned one, so it covers bases and offsets up to 64 bits
+    for (size_t output_index = 0; output_index < input_size; output_index += 4)
+    {
+        _mm256_storeu_si256((__m256i*)&output[output_index], _mm256_add_epi64(unpack.next(output_index), base_vector));
+    }
+}
+
+int scan_256_64bit(uint64_t predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    Unpack64bit unpack(input, compression);
+    __m256i predicate = _mm256_set1_epi64x(predicate_key);
+
+    int hits = 0;
+    size_t output_index = 0;
+
+    while (8 * output_index < input_size)
+    {
+        __m256i e1 = _mm256_cmpeq_epi64(unpack.next(8 * output_index), predicate);
+        __m256i e2 = _mm256_cmpeq_epi64(unpack.next(8 * output_index + 4), predicate);
+
+        uint8_t out = _mm256_movemask_pd(_mm256_castsi256_pd(e1)) | (_mm256_movemask_pd(_mm256_castsi256_pd(e2)) << 4);
+
+        // the elements past input_size are zero padding and match key 0
+        size_t remaining = input_size - 8 * output_index;
+        if (remaining < 8) out &= (1u << remaining) - 1;
+
+        output[output_index] = out;
+        output_index += 1;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+int scan_range_256_64bit(uint64_t predicate_low, uint64_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    Unpack64bit unpack(input, compression);
+
+    // there is no unsigned 64 bit compare, flipping the sign bit maps it to the signed one
+    __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    __m256i low = _mm256_xor_si256(_mm256_set1_epi64x(predicate_low), sign);
+    __m256i high = _mm256_xor_si256(_mm256_set1_epi64x(predicate_high), sign);
+
+    auto in_range = [&](__m256i elements)
+    {
+        __m256i c = _mm256_xor_si256(elements, sign);
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(low, c), _mm256_cmpgt_epi64(c, high));
+        return ~_mm256_movemask_pd(_mm256_castsi256_pd(outside)) & 0xF;
+    };
+
+    int hits = 0;
+    size_t output_index = 0;
+
+    while (8 * output_index < input_size)
+    {
+        int out1 = in_range(unpack.next(8 * output_index));
+        int out2 = in_range(unpack.next(8 * output_index + 4));
+
+        uint8_t out = out1 | (out2 << 4);
+
+        size_t remaining = input_size - 8 * output_index;
+        if (remaining < 8) out &= (1u << remaining) - 1;
+
+        output[output_index] = out;
+        output_index += 1;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
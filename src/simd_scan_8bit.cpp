@@ -0,0 +1,48 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* 8 bit lanes (compression 1-8): 16 elements span at most 16 bytes, so one load covers two groups of 8.
+* Both groups are unpacked into 16 bit lanes (see Masks16bit) and packed into bytes.
+*/
+
+inline __m128i __unpack_8bit_128(uint8_t* input, size_t index, size_t compression, Masks16bit const& first, Masks16bit const& second)
+{
+    __m128i source = _mm_loadu_si128((__m128i*)&input[index * compression / 8]);
+    return _mm_packus_epi16(unpack_16bit_128(source, compression, first), unpack_16bit_128(source, compression, second));
+}
+
+void decompress_128_8bit(__m128i* input, size_t input_size, size_t compression, uint8_t* output)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit first(compression), second(compression, compression);
+
+    for (size_t output_index = 0; output_index < input_size; output_index += 16)
+    {
+        _mm_storeu_si128((__m128i*)&output[output_index], __unpack_8bit_128(in, output_index, compression, first, second));
+    }
+}
+
+int scan_128_8bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit first(compression), second(compression, compression);
+    __m128i predicate = _mm_set1_epi8((int8_t)predicate_key);
+
+    int hits = 0;
+
+    for (size_t i = 0; i < input_size; i += 16)
+    {
+        __m128i e = _mm_cmpeq_epi8(__unpack_8bit_128(in, i, compression, first, second), predicate);
+
+        uint16_t out = _mm_movemask_epi8(e);
+        memcpy(&output[i / 8], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
@@ -0,0 +1,47 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+// 8 bit lanes, see simd_scan_8bit.cpp
+
+// 32 elements, the lower lane holds elements 0-15, the upper lane elements 16-31 (no cross-lane fix needed)
+inline __m256i __unpack_8bit_256(uint8_t* input, size_t index, size_t compression, Masks16bit const& first, Masks16bit const& second)
+{
+    uint8_t* group = &input[index * compression / 8];
+    __m256i source = _mm256_loadu2_m128i((__m128i*)&group[2 * compression], (__m128i*)group);
+    return _mm256_packus_epi16(unpack_16bit_256(source, compression, first), unpack_16bit_256(source, compression, second));
+}
+
+void decompress_256_8bit(__m128i* input, size_t input_size, size_t compression, uint8_t* output)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit first(compression), second(compression, compression);
+
+    for (size_t output_index = 0; output_index < input_size; output_index += 32)
+    {
+        _mm256_storeu_si256((__m256i*)&output[output_index], __unpack_8bit_256(in, output_index, compression, first, second));
+    }
+}
+
+int scan_256_8bit(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    uint8_t* in = (uint8_t*)input;
+    Masks16bit first(compression), second(compression, compression);
+    __m256i predicate = _mm256_set1_epi8((int8_t)predicate_key);
+
+    int hits = 0;
+
+    for (size_t i = 0; i < input_size; i += 32)
+    {
+        __m256i e = _mm256_cmpeq_epi8(__unpack_8bit_256(in, i, compression, first, second), predicate);
+
+        uint32_t out = _mm256_movemask_epi8(e);
+        memcpy(&output[i / 8], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
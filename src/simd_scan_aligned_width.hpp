@@ -0,0 +1,262 @@
+#pragma once
+#include <immintrin.h>
+#include <cstring>
+#include <vector>
+
+#include "simd_scan_commons.hpp"
+#include "simd_scan_specialized.hpp"
+#include "util.hpp"
+
+/*
+* Kernels for widths that divide 32 (1, 2, 4, 8, 16, 32 bit): elements never straddle a byte (or a lane)
+* boundary, so the input is compared and decoded in place without shuffle, multiply and shift.
+* A block covers 16 input bytes (32 for 32 bit), the last incomplete block is handled by the scalar tail.
+*/
+
+constexpr bool is_aligned_width(size_t compression)
+{
+    return compression == 1 || compression == 2 || compression == 4
+        || compression == 8 || compression == 16 || compression == 32;
+}
+
+template <unsigned BITS>
+struct AlignedWidth
+{
+    static constexpr size_t block_bytes = BITS == 32 ? 32 : 16;
+    static constexpr size_t block_size = block_bytes * 8 / BITS;
+};
+
+// the predicate key repeated in every element of a 128 bit register
+template <unsigned BITS>
+inline __m128i __aligned_width_predicate(uint32_t predicate_key)
+{
+    if constexpr (BITS == 1) return _mm_set1_epi8(predicate_key ? 0 : -1);
+    else if constexpr (BITS == 2) return _mm_set1_epi8(predicate_key * 0x55);
+    else if constexpr (BITS == 4) return _mm_set1_epi8(predicate_key * 0x11);
+    else if constexpr (BITS == 8) return _mm_set1_epi8(predicate_key);
+    else if constexpr (BITS == 16) return _mm_set1_epi16(predicate_key);
+    else return _mm_set1_epi32(predicate_key);
+}
+
+// writes the bitmap of one block (block_size / 8 bytes) and returns the hits
+template <unsigned BITS>
+inline int __scan_aligned_width_block(const uint8_t* block, __m128i predicate, uint8_t* output)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i source = _mm_loadu_si128((__m128i*)block);
+
+    if constexpr (BITS == 1)
+    {
+        // the input already is a bitmap, bits equal to the key are set
+        __m128i out = _mm_xor_si128(source, predicate);
+        _mm_storeu_si128((__m128i*)output, out);
+        return POPCNT64(_mm_extract_epi64(out, 0)) + POPCNT64(_mm_extract_epi64(out, 1));
+    }
+    else if constexpr (BITS == 2)
+    {
+        // a matching element is 0 after the xor, the four fields of each byte are interleaved afterwards
+        __m128i x = _mm_xor_si128(source, predicate);
+        __m128i m0 = _mm_cmpeq_epi8(_mm_and_si128(x, _mm_set1_epi8(0x03)), zero);
+        __m128i m1 = _mm_cmpeq_epi8(_mm_and_si128(x, _mm_set1_epi8(0x0C)), zero);
+        __m128i m2 = _mm_cmpeq_epi8(_mm_and_si128(x, _mm_set1_epi8(0x30)), zero);
+        __m128i m3 = _mm_cmpeq_epi8(_mm_and_si128(x, _mm_set1_epi8(-64)), zero);
+
+        __m128i a = _mm_unpacklo_epi8(m0, m1), b = _mm_unpacklo_epi8(m2, m3);
+        __m128i c = _mm_unpackhi_epi8(m0, m1), d = _mm_unpackhi_epi8(m2, m3);
+
+        uint64_t out = uint64_t(uint16_t(_mm_movemask_epi8(_mm_unpacklo_epi16(a, b))))
+            | uint64_t(uint16_t(_mm_movemask_epi8(_mm_unpackhi_epi16(a, b)))) << 16
+            | uint64_t(uint16_t(_mm_movemask_epi8(_mm_unpacklo_epi16(c, d)))) << 32
+            | uint64_t(uint16_t(_mm_movemask_epi8(_mm_unpackhi_epi16(c, d)))) << 48;
+        memcpy(output, &out, sizeof(out));
+        return POPCNT64(out);
+    }
+    else if constexpr (BITS == 4)
+    {
+        __m128i x = _mm_xor_si128(source, predicate);
+        __m128i m0 = _mm_cmpeq_epi8(_mm_and_si128(x, _mm_set1_epi8(0x0F)), zero);
+        __m128i m1 = _mm_cmpeq_epi8(_mm_and_si128(x, _mm_set1_epi8(-16)), zero);
+
+        uint32_t out = uint32_t(uint16_t(_mm_movemask_epi8(_mm_unpacklo_epi8(m0, m1))))
+            | uint32_t(_mm_movemask_epi8(_mm_unpackhi_epi8(m0, m1))) << 16;
+        memcpy(output, &out, sizeof(out));
+        return POPCNT(out);
+    }
+    else if constexpr (BITS == 8)
+    {
+        uint16_t out = _mm_movemask_epi8(_mm_cmpeq_epi8(source, predicate));
+        memcpy(output, &out, sizeof(out));
+        return POPCNT(out);
+    }
+    else if constexpr (BITS == 16)
+    {
+        __m128i e = _mm_cmpeq_epi16(source, predicate);
+        uint8_t out = _mm_movemask_epi8(_mm_packs_epi16(e, zero));
+        output[0] = out;
+        return POPCNT(out);
+    }
+    else
+    {
+        __m128i e1 = _mm_cmpeq_epi32(source, predicate);
+        __m128i e2 = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)&block[16]), predicate);
+        uint8_t out = _mm_movemask_ps(_mm_castsi128_ps(e1)) | (_mm_movemask_ps(_mm_castsi128_ps(e2)) << 4);
+        output[0] = out;
+        return POPCNT(out);
+    }
+}
+
+// widens 16 byte elements to int
+inline void __store_bytes_as_int(__m128i elements, int* output)
+{
+    _mm_storeu_si128((__m128i*)&output[0], _mm_cvtepu8_epi32(elements));
+    _mm_storeu_si128((__m128i*)&output[4], _mm_cvtepu8_epi32(_mm_srli_si128(elements, 4)));
+    _mm_storeu_si128((__m128i*)&output[8], _mm_cvtepu8_epi32(_mm_srli_si128(elements, 8)));
+    _mm_storeu_si128((__m128i*)&output[12], _mm_cvtepu8_epi32(_mm_srli_si128(elements, 12)));
+}
+
+// decoded 4 bit nibbles of 1 bit elements
+struct NibbleTable1Bit
+{
+    alignas(16) int32_t elements[16][4];
+
+    constexpr NibbleTable1Bit() : elements()
+    {
+        for (size_t nibble = 0; nibble < 16; nibble++)
+        {
+            for (size_t i = 0; i < 4; i++)
+            {
+                elements[nibble][i] = (nibble >> i) & 1;
+            }
+        }
+    }
+};
+
+constexpr NibbleTable1Bit nibble_table_1bit;
+
+template <unsigned BITS>
+inline void __decompress_aligned_width_block(const uint8_t* block, int* output)
+{
+    if constexpr (BITS == 1)
+    {
+        for (size_t i = 0; i < 16; i++)
+        {
+            _mm_storeu_si128((__m128i*)&output[8 * i], _mm_load_si128((__m128i*)nibble_table_1bit.elements[block[i] & 0x0F]));
+            _mm_storeu_si128((__m128i*)&output[8 * i + 4], _mm_load_si128((__m128i*)nibble_table_1bit.elements[block[i] >> 4]));
+        }
+    }
+    else if constexpr (BITS == 2)
+    {
+        // each nibble holds two elements, the shuffle tables decode the lower and the upper one
+        const __m128i table_low = _mm_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3);
+        const __m128i table_high = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+
+        __m128i source = _mm_loadu_si128((__m128i*)block);
+        __m128i n0 = _mm_and_si128(source, _mm_set1_epi8(0x0F));
+        __m128i n1 = _mm_and_si128(_mm_srli_epi16(source, 4), _mm_set1_epi8(0x0F));
+
+        __m128i e0 = _mm_shuffle_epi8(table_low, n0);
+        __m128i e1 = _mm_shuffle_epi8(table_high, n0);
+        __m128i e2 = _mm_shuffle_epi8(table_low, n1);
+        __m128i e3 = _mm_shuffle_epi8(table_high, n1);
+
+        __m128i a = _mm_unpacklo_epi8(e0, e1), b = _mm_unpacklo_epi8(e2, e3);
+        __m128i c = _mm_unpackhi_epi8(e0, e1), d = _mm_unpackhi_epi8(e2, e3);
+
+        __store_bytes_as_int(_mm_unpacklo_epi16(a, b), &output[0]);
+        __store_bytes_as_int(_mm_unpackhi_epi16(a, b), &output[16]);
+        __store_bytes_as_int(_mm_unpacklo_epi16(c, d), &output[32]);
+        __store_bytes_as_int(_mm_unpackhi_epi16(c, d), &output[48]);
+    }
+    else if constexpr (BITS == 4)
+    {
+        __m128i source = _mm_loadu_si128((__m128i*)block);
+        __m128i e0 = _mm_and_si128(source, _mm_set1_epi8(0x0F));
+        __m128i e1 = _mm_and_si128(_mm_srli_epi16(source, 4), _mm_set1_epi8(0x0F));
+
+        __store_bytes_as_int(_mm_unpacklo_epi8(e0, e1), &output[0]);
+        __store_bytes_as_int(_mm_unpackhi_epi8(e0, e1), &output[16]);
+    }
+    else if constexpr (BITS == 8)
+    {
+        __store_bytes_as_int(_mm_loadu_si128((__m128i*)block), output);
+    }
+    else if constexpr (BITS == 16)
+    {
+        __m128i source = _mm_loadu_si128((__m128i*)block);
+        _mm_storeu_si128((__m128i*)&output[0], _mm_cvtepu16_epi32(source));
+        _mm_storeu_si128((__m128i*)&output[4], _mm_cvtepu16_epi32(_mm_srli_si128(source, 8)));
+    }
+    else
+    {
+        memcpy(output, block, 32);
+    }
+}
+
+template <unsigned BITS>
+void decompress_aligned_width(const uint8_t* input, size_t input_size, int* output)
+{
+    using Width = AlignedWidth<BITS>;
+    size_t block_count = input_size / Width::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        __decompress_aligned_width_block<BITS>(&input[block_index * Width::block_bytes], &output[block_index * Width::block_size]);
+    }
+
+    decompress_tail(input, block_count * Width::block_size, input_size, BITS, output);
+}
+
+template <unsigned BITS>
+int scan_aligned_width(uint32_t predicate_key, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    using Width = AlignedWidth<BITS>;
+    __m128i predicate = __aligned_width_predicate<BITS>(predicate_key);
+
+    int hits = 0;
+    size_t block_count = input_size / Width::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        hits += __scan_aligned_width_block<BITS>(&input[block_index * Width::block_bytes], predicate, &output[block_index * Width::block_size / 8]);
+    }
+
+    hits += scan_tail(predicate_key, input, block_count * Width::block_size, input_size, BITS, output);
+    return hits;
+}
+
+template <unsigned BITS>
+void shared_scan_aligned_width(std::vector<int> const& predicate_keys, const uint8_t* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+{
+    using Width = AlignedWidth<BITS>;
+
+    // the predicate patterns only repeat the lower bits of the key, so larger keys are excluded up front
+    std::vector<size_t> key_ids;
+    for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+    {
+        if ((uint32_t)predicate_keys[key_id] > code_mask(BITS))
+        {
+            std::fill(outputs[key_id].begin(), outputs[key_id].begin() + (input_size + 7) / 8, 0);
+            continue;
+        }
+
+        key_ids.push_back(key_id);
+    }
+
+    size_t block_count = input_size / Width::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Width::block_bytes];
+
+        for (size_t key_id : key_ids)
+        {
+            __m128i predicate = __aligned_width_predicate<BITS>(predicate_keys[key_id]);
+            __scan_aligned_width_block<BITS>(block, predicate, &outputs[key_id][block_index * Width::block_size / 8]);
+        }
+    }
+
+    for (size_t key_id : key_ids)
+    {
+        scan_tail(predicate_keys[key_id], input, block_count * Width::block_size, input_size, BITS, outputs[key_id].data());
+    }
+}
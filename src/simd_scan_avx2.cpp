@@ -0,0 +1,168 @@
+#include <iostream>
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#else
+#  include <x86intrin.h>
+#endif
+
+#include <immintrin.h>
+#include <cmath>
+#include <vector>
+#include <bitset>
+#include <algorithm>
+#include <cstring> // memcpy
+
+#include "simd_scan.hpp"
+#include "profiling.hpp"
+#include "util.hpp"
+#include "simd_scan_commons.hpp"
+
+int scan_256(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    int hits = 0;
+
+    //avxi_t source = _mm256_loadu_si256(input);
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
+
+    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
+
+    __m256i clean_mask = generate_clean_mask_256(compression);
+
+    __m256i predicate = generate_predicate_mask_256(compression, predicate_key);
+
+    while (8 * output_index < input_size)
+    {
+        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+        __m256i c = _mm256_and_si256(b, clean_mask);
+        __m256i e = _mm256_cmpeq_epi32(c, predicate);
+
+        int matches = _mm256_movemask_ps(_mm256_castsi256_ps(e));
+        hits += POPCNT(matches);
+        output[output_index] = matches;
+
+        // load next
+        output_index += 1;
+        size_t total_processed_bytes = (8 * output_index) * compression / 8;
+        source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+    }
+
+    return hits;
+}
+
+int scan_256_wide(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    int hits = 0;
+
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    size_t output_index = 0; // current write index of the output array
+
+    __m128i shuffle_mask_low[2], shuffle_mask_high[2];
+    generate_wide_shuffle_masks_128(compression, shuffle_mask_low, shuffle_mask_high);
+
+    __m128i shift_mask[2];
+    generate_wide_shift_masks_128(compression, shift_mask);
+
+    // lower lane holds elements 0-3, upper lane elements 4-7
+    __m256i shuffle_mask_low_256 = _mm256_set_m128i(shuffle_mask_low[1], shuffle_mask_low[0]);
+    __m256i shuffle_mask_high_256 = _mm256_set_m128i(shuffle_mask_high[1], shuffle_mask_high[0]);
+    __m256i shift_mask_256 = _mm256_set_m128i(shift_mask[1], shift_mask[0]);
+    __m256i and_mask = _mm256_set1_epi32(code_mask(compression));
+    __m256i predicate = _mm256_set1_epi32(predicate_key);
+
+    while (8 * output_index < input_size)
+    {
+        __m256i d = unpack_wide_256(source, shuffle_mask_low_256, shuffle_mask_high_256, shift_mask_256, and_mask);
+        __m256i e = _mm256_cmpeq_epi32(d, predicate);
+
+        int matches = _mm256_movemask_ps(_mm256_castsi256_ps(e));
+        hits += POPCNT(matches);
+        output[output_index] = matches;
+
+        // load next
+        output_index += 1;
+        size_t total_processed_bytes = (8 * output_index) * compression / 8;
+        source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+    }
+
+    return hits;
+}
+
+inline void __scan_256_step(uint32_t& out, size_t const& offset, __m256i const& shuffle_mask,
+    __m256i const& clean_mask, __m256i const& predicate, size_t const& output_index, size_t const& compression,
+    __m128i* input, __m256i& source)
+{
+    __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+    __m256i c = _mm256_and_si256(b, clean_mask);
+    __m256i e = _mm256_cmpeq_epi32(c, predicate);
+
+    out |= _mm256_movemask_ps(_mm256_castsi256_ps(e)) << offset;
+
+    // load next
+    size_t total_processed_bytes = (32 * output_index + offset + 8) * compression / 8;
+    source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+}
+
+int scan_256_unrolled(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    int hits = 0;
+
+    //avxi_t source = _mm256_loadu_si256(input);
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    uint32_t* output_array = reinterpret_cast<uint32_t*>(output.data());
+    size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
+
+    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
+
+    __m256i clean_mask = generate_clean_mask_256(compression);
+
+    __m256i predicate = generate_predicate_mask_256(compression, predicate_key);
+
+    while (32 * output_index < input_size)
+    {
+        uint32_t out = 0;
+
+        __scan_256_step(out,  0, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
+        __scan_256_step(out,  8, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
+        __scan_256_step(out, 16, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
+        __scan_256_step(out, 24, shuffle_mask, clean_mask, predicate, output_index, compression, input, source);
+
+        output_array[output_index] = out;
+        output_index += 1;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+// 32 elements per iteration from full 32 byte loads
+int scan_256_permute(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    const uint8_t* next = (uint8_t*)input;
+    PermuteMasks256 masks(compression);
+    __m256i predicate = _mm256_set1_epi32(predicate_key);
+
+    int hits = 0;
+
+    // 16 elements span exactly 2 * compression bytes
+    for (size_t i = 0; i < input_size; i += 32, next += 4 * compression)
+    {
+        __m256i e1 = _mm256_cmpeq_epi32(unpack_permute_256(next, masks, 0), predicate);
+        __m256i e2 = _mm256_cmpeq_epi32(unpack_permute_256(next, masks, 1), predicate);
+        __m256i e3 = _mm256_cmpeq_epi32(unpack_permute_256(&next[2 * compression], masks, 0), predicate);
+        __m256i e4 = _mm256_cmpeq_epi32(unpack_permute_256(&next[2 * compression], masks, 1), predicate);
+
+        uint32_t out = _mm256_movemask_ps(_mm256_castsi256_ps(e1))
+            | (_mm256_movemask_ps(_mm256_castsi256_ps(e2)) << 8)
+            | (_mm256_movemask_ps(_mm256_castsi256_ps(e3)) << 16)
+            | (_mm256_movemask_ps(_mm256_castsi256_ps(e4)) << 24);
+        memcpy(&output[i / 8], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
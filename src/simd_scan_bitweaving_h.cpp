@@ -0,0 +1,263 @@
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* BitWeaving/H layout, SWAR kernels
+*
+* Every code occupies a field of compression + 1 bits, the top bit of the field (delimiter) is zero
+* and fields never cross a 64bit word. A segment consists of compression + 1 words, field j of word
+* i holds the code i + j * (compression + 1) of the segment. The predicates leave their result in
+* the delimiter bits, so shifting the result of word i right by compression - i and combining the
+* words of a segment yields the bitmap of the segment in element order.
+*
+* With X the fields of a word and K a replicated constant:
+*   X == K:  ~((X ^ K) + low_bits) & delimiters     (a non-zero field carries into its delimiter)
+*   X < K:   ((X ^ low_bits) + K) & delimiters      (K + (2^c - 1 - X) >= 2^c)
+*   X <= K:  ((X ^ low_bits) + (K + 1)) & delimiters
+* The delimiters absorb the carries, so no field affects its neighbour.
+*/
+
+template <unsigned BITS>
+struct BitWeavingH
+{
+    static constexpr size_t field_bits = BITS + 1;
+    static constexpr size_t fields = 64 / field_bits; // fields per word
+    static constexpr size_t segment_words = field_bits;
+    static constexpr size_t segment_size = fields * segment_words; // elements per segment, at most 64
+
+    // bit 0 of every field
+    static constexpr uint64_t replicate_mask()
+    {
+        uint64_t mask = 0;
+        for (size_t j = 0; j < fields; j++) mask |= uint64_t(1) << (j * field_bits);
+        return mask;
+    }
+
+    static constexpr uint64_t ones = replicate_mask();
+    static constexpr uint64_t low_bits = ones * code_mask(BITS);
+    static constexpr uint64_t delimiters = ones << BITS;
+
+    static uint64_t replicate(uint64_t value)
+    {
+        return value * ones;
+    }
+};
+
+static size_t bitweaving_h_segment_size(size_t compression)
+{
+    return 64 / (compression + 1) * (compression + 1);
+}
+
+size_t bitweaving_h_buffer_size(size_t compression, size_t input_size)
+{
+    size_t segment_size = bitweaving_h_segment_size(compression);
+    size_t segments = (input_size + segment_size - 1) / segment_size;
+    return segments * (compression + 1) * sizeof(uint64_t);
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_bitweaving_h(std::vector<T> const& input, size_t compression)
+{
+    auto buffer = std::make_unique<uint64_t[]>(bitweaving_h_buffer_size(compression, input.size()) / sizeof(uint64_t));
+
+    size_t segment_size = bitweaving_h_segment_size(compression);
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        size_t segment = i / segment_size;
+        size_t word = i % segment_size % (compression + 1);
+        size_t field = i % segment_size / (compression + 1);
+
+        uint64_t element = uint64_t(input[i]) & code_mask(compression);
+        buffer[segment * (compression + 1) + word] |= element << (field * (compression + 1));
+    }
+
+    return buffer;
+}
+
+void decompress_bitweaving_h(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    const uint64_t* words = (const uint64_t*)input;
+
+    size_t segment_size = bitweaving_h_segment_size(compression);
+    for (size_t i = 0; i < input_size; i++)
+    {
+        size_t segment = i / segment_size;
+        size_t word = i % segment_size % (compression + 1);
+        size_t field = i % segment_size / (compression + 1);
+
+        output[i] = (int)((words[segment * (compression + 1) + word] >> (field * (compression + 1))) & code_mask(compression));
+    }
+}
+
+/*
+* Appends the bitmaps of the segments (segment_size bits each, up to 64) to the output
+*/
+
+class BitmapWriter
+{
+private:
+    uint8_t* output;
+    uint64_t pending = 0;
+    size_t pending_bits = 0;
+
+public:
+    BitmapWriter(uint8_t* output) : output(output) {}
+
+    void append(uint64_t bits, size_t count)
+    {
+        pending |= bits << pending_bits;
+        if (pending_bits + count < 64)
+        {
+            pending_bits += count;
+            return;
+        }
+
+        memcpy(output, &pending, sizeof(pending));
+        output += sizeof(pending);
+
+        size_t written = 64 - pending_bits;
+        pending = written < 64 ? bits >> written : 0;
+        pending_bits = count - written;
+    }
+
+    void flush()
+    {
+        memcpy(output, &pending, (pending_bits + 7) / 8);
+    }
+};
+
+template <unsigned BITS, typename Predicate, size_t... WORD>
+inline uint64_t __scan_bitweaving_h_segment(const uint64_t* segment, Predicate const& predicate, std::index_sequence<WORD...>)
+{
+    return ((predicate(segment[WORD]) >> (BITS - WORD)) | ...);
+}
+
+// predicate maps a word to its delimiter bits
+template <unsigned BITS, typename Predicate>
+static int __scan_bitweaving_h(const uint8_t* input, size_t input_size, Predicate const& predicate, uint8_t* output)
+{
+    using Layout = BitWeavingH<BITS>;
+    const uint64_t* words = (const uint64_t*)input;
+
+    BitmapWriter writer(output);
+    int hits = 0;
+
+    size_t full_segments = input_size / Layout::segment_size;
+    for (size_t segment = 0; segment < full_segments; segment++)
+    {
+        uint64_t bitmap = __scan_bitweaving_h_segment<BITS>(words + segment * Layout::segment_words, predicate,
+            std::make_index_sequence<Layout::segment_words>());
+        writer.append(bitmap, Layout::segment_size);
+        hits += (int)POPCNT64(bitmap);
+    }
+
+    // the zero padding of the last segment must not match
+    size_t rest = input_size % Layout::segment_size;
+    if (rest > 0)
+    {
+        uint64_t bitmap = __scan_bitweaving_h_segment<BITS>(words + full_segments * Layout::segment_words, predicate,
+            std::make_index_sequence<Layout::segment_words>());
+        bitmap &= (uint64_t(1) << rest) - 1;
+        writer.append(bitmap, rest);
+        hits += (int)POPCNT64(bitmap);
+    }
+
+    writer.flush();
+    return hits;
+}
+
+template <unsigned BITS>
+static int scan_bitweaving_h_static(uint32_t predicate_key, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    using Layout = BitWeavingH<BITS>;
+    const uint64_t key = Layout::replicate(predicate_key);
+
+    return __scan_bitweaving_h<BITS>(input, input_size, [=](uint64_t word)
+    {
+        return ~((word ^ key) + Layout::low_bits) & Layout::delimiters;
+    }, output);
+}
+
+template <unsigned BITS>
+static int scan_range_bitweaving_h_static(uint32_t predicate_low, uint32_t predicate_high, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    using Layout = BitWeavingH<BITS>;
+
+    // low <= x <= high: !(x < low) && x < high + 1, high + 1 may use the delimiter bit
+    const uint64_t low = Layout::replicate(predicate_low);
+    const uint64_t high = Layout::replicate(uint64_t(predicate_high) + 1);
+
+    return __scan_bitweaving_h<BITS>(input, input_size, [=](uint64_t word)
+    {
+        uint64_t complement = word ^ Layout::low_bits;
+        uint64_t less_low = complement + low;
+        uint64_t less_equal_high = complement + high;
+        return ~less_low & less_equal_high & Layout::delimiters;
+    }, output);
+}
+
+typedef int (*scan_function)(uint32_t, const uint8_t*, size_t, uint8_t*);
+typedef int (*scan_range_function)(uint32_t, uint32_t, const uint8_t*, size_t, uint8_t*);
+
+template <size_t... I>
+constexpr std::array<scan_function, sizeof...(I) + 1> __make_scan_table(std::index_sequence<I...>)
+{
+    return { nullptr, &scan_bitweaving_h_static<I + 1>... };
+}
+
+template <size_t... I>
+constexpr std::array<scan_range_function, sizeof...(I) + 1> __make_scan_range_table(std::index_sequence<I...>)
+{
+    return { nullptr, &scan_range_bitweaving_h_static<I + 1>... };
+}
+
+static constexpr auto scan_table = __make_scan_table(std::make_index_sequence<32>());
+static constexpr auto scan_range_table = __make_scan_range_table(std::make_index_sequence<32>());
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int scan_bitweaving_h(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // keys that can't be represented with the given compression never match
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    return scan_table[compression](predicate_key, (uint8_t*)input, input_size, output.data());
+}
+
+int scan_range_bitweaving_h(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // clamp the predicate to the codes [0, code_mask]
+    predicate_high = std::min(predicate_high, code_mask(compression));
+    if (predicate_low > predicate_high)
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    return scan_range_table[compression](predicate_low, predicate_high, (uint8_t*)input, input_size, output.data());
+}
+
+template std::unique_ptr<uint64_t[]> compress_bitweaving_h<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_bitweaving_h<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
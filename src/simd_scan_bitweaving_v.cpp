@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* BitWeaving/V layout, 128bit kernels
+*
+* A segment holds 128 consecutive codes as compression slices of 128 bits, slice j contains the
+* bit compression - 1 - j of all codes (most significant bit first), bit p of a slice belongs to
+* the code p of the segment. A scan compares the slices with the bits of the constants from the
+* most significant bit down and keeps a mask of the codes that are still equal to the constant
+* (undecided). Once no code of a segment is undecided, the remaining slices aren't touched.
+*/
+
+static const size_t segment_size = 128;
+
+size_t bitweaving_v_buffer_size(size_t compression, size_t input_size)
+{
+    size_t segments = (input_size + segment_size - 1) / segment_size;
+    return segments * compression * sizeof(__m128i);
+}
+
+// transposes up to segment_size codes into the slices of a segment
+static void __slice_segment(const uint32_t* input, size_t count, size_t compression, __m128i* segment)
+{
+    alignas(16) uint32_t codes[segment_size] = {};
+    memcpy(codes, input, count * sizeof(uint32_t));
+
+    for (size_t bit = 0; bit < compression; bit++)
+    {
+        // moves the bit to the sign bit of the lanes
+        const __m128i shift = _mm_cvtsi32_si128(31 - bit);
+
+        uint64_t slice[2] = {};
+        for (size_t i = 0; i < segment_size; i += 4)
+        {
+            __m128i elements = _mm_sll_epi32(_mm_load_si128((__m128i*)(codes + i)), shift);
+            uint64_t bits = _mm_movemask_ps(_mm_castsi128_ps(elements));
+            slice[i / 64] |= bits << (i % 64);
+        }
+
+        _mm_store_si128(segment + compression - 1 - bit, _mm_loadu_si128((__m128i*)slice));
+    }
+}
+
+static std::unique_ptr<uint64_t[]> __slice(const uint32_t* input, size_t input_size, size_t compression)
+{
+    auto buffer = std::make_unique<uint64_t[]>(bitweaving_v_buffer_size(compression, input_size) / sizeof(uint64_t));
+    __m128i* segments = (__m128i*)buffer.get();
+
+    for (size_t begin = 0; begin < input_size; begin += segment_size)
+    {
+        size_t count = std::min(segment_size, input_size - begin);
+        __slice_segment(input + begin, count, compression, segments + begin / segment_size * compression);
+    }
+
+    return buffer;
+}
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_bitweaving_v(std::vector<T> const& input, size_t compression)
+{
+    if (!check_compression(compression)) return nullptr;
+
+    std::vector<uint32_t> codes(input.size());
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        codes[i] = (uint32_t)input[i] & code_mask(compression);
+    }
+
+    return __slice(codes.data(), codes.size(), compression);
+}
+
+std::unique_ptr<uint64_t[]> bitweaving_v_from_packed(__m128i* input, size_t input_size, size_t compression)
+{
+    if (!check_compression(compression)) return nullptr;
+
+    std::vector<int> codes(decompression_output_buffer_size(input_size) / sizeof(int));
+    decompress(input, input_size, compression, codes.data());
+
+    return __slice((uint32_t*)codes.data(), input_size, compression);
+}
+
+void decompress_bitweaving_v(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    if (!check_compression(compression)) return;
+
+    // lane i is set if bit i of the index is set
+    alignas(16) static const uint32_t expand[16][4] = {
+        { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 1, 1, 0, 0 },
+        { 0, 0, 1, 0 }, { 1, 0, 1, 0 }, { 0, 1, 1, 0 }, { 1, 1, 1, 0 },
+        { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 1, 1, 0, 1 },
+        { 0, 0, 1, 1 }, { 1, 0, 1, 1 }, { 0, 1, 1, 1 }, { 1, 1, 1, 1 } };
+
+    const uint64_t* slices = (const uint64_t*)input;
+
+    for (size_t begin = 0; begin < input_size; begin += segment_size)
+    {
+        const uint64_t* segment = slices + begin / segment_size * compression * 2;
+        size_t count = std::min(segment_size, input_size - begin);
+
+        // the last segment goes through a temporary buffer to not write past input_size elements
+        alignas(16) int codes[segment_size];
+        int* segment_output = count == segment_size ? output + begin : codes;
+
+        for (size_t i = 0; i < segment_size; i += 4)
+        {
+            __m128i elements = _mm_setzero_si128();
+            for (size_t j = 0; j < compression; j++)
+            {
+                size_t nibble = (segment[2 * j + i / 64] >> (i % 64)) & 0xF;
+                __m128i bits = _mm_sll_epi32(_mm_load_si128((__m128i*)expand[nibble]), _mm_cvtsi32_si128(compression - 1 - j));
+                elements = _mm_or_si128(elements, bits);
+            }
+            _mm_storeu_si128((__m128i*)(segment_output + i), elements);
+        }
+
+        if (count < segment_size)
+        {
+            memcpy(output + begin, codes, count * sizeof(int));
+        }
+    }
+}
+
+std::unique_ptr<uint64_t[]> bitweaving_v_to_packed(__m128i* input, size_t input_size, size_t compression)
+{
+    if (!check_compression(compression)) return nullptr;
+
+    std::vector<uint32_t> codes(decompression_output_buffer_size(input_size) / sizeof(int));
+    decompress_bitweaving_v(input, input_size, compression, (int*)codes.data());
+    codes.resize(input_size);
+
+    return compress_128(codes, compression);
+}
+
+// writes the bitmap of a segment, only count bits of the last segment are written
+static int __store_segment_bitmap(__m128i bitmap, size_t count, uint8_t* output)
+{
+    uint64_t bits[2];
+    _mm_storeu_si128((__m128i*)bits, bitmap);
+
+    if (count == segment_size)
+    {
+        memcpy(output, bits, sizeof(bits));
+        return (int)(POPCNT64(bits[0]) + POPCNT64(bits[1]));
+    }
+
+    // the zero padding of the last segment must not match
+    if (count <= 64)
+    {
+        if (count < 64) bits[0] &= (uint64_t(1) << count) - 1;
+        bits[1] = 0;
+    }
+    else
+    {
+        bits[1] &= (uint64_t(1) << (count - 64)) - 1;
+    }
+
+    memcpy(output, bits, (count + 7) / 8);
+    return (int)(POPCNT64(bits[0]) + POPCNT64(bits[1]));
+}
+
+// all ones if bit (compression - 1 - slice) of value is set
+static __m128i __constant_slice(uint32_t value, size_t compression, size_t slice)
+{
+    return _mm_set1_epi32(-(int)((value >> (compression - 1 - slice)) & 1));
+}
+
+int scan_bitweaving_v(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // keys that can't be represented with the given compression never match
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    __m128i key[32];
+    for (size_t j = 0; j < compression; j++)
+    {
+        key[j] = __constant_slice(predicate_key, compression, j);
+    }
+
+    int hits = 0;
+    for (size_t begin = 0; begin < input_size; begin += segment_size)
+    {
+        const __m128i* segment = input + begin / segment_size * compression;
+
+        __m128i equal = _mm_set1_epi32(-1);
+        for (size_t j = 0; j < compression && !_mm_testz_si128(equal, equal); j++)
+        {
+            __m128i slice = _mm_load_si128(segment + j);
+            equal = _mm_andnot_si128(_mm_xor_si128(slice, key[j]), equal);
+        }
+
+        hits += __store_segment_bitmap(equal, std::min(segment_size, input_size - begin), output.data() + begin / 8);
+    }
+
+    return hits;
+}
+
+int scan_range_bitweaving_v(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // clamp the predicate to the codes [0, code_mask]
+    predicate_high = std::min(predicate_high, code_mask(compression));
+    if (predicate_low > predicate_high)
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    __m128i low[32];
+    __m128i high[32];
+    for (size_t j = 0; j < compression; j++)
+    {
+        low[j] = __constant_slice(predicate_low, compression, j);
+        high[j] = __constant_slice(predicate_high, compression, j);
+    }
+
+    int hits = 0;
+    for (size_t begin = 0; begin < input_size; begin += segment_size)
+    {
+        const __m128i* segment = input + begin / segment_size * compression;
+
+        // codes above low/below high, codes still equal to the prefix of low/high
+        __m128i greater = _mm_setzero_si128();
+        __m128i less = _mm_setzero_si128();
+        __m128i equal_low = _mm_set1_epi32(-1);
+        __m128i equal_high = _mm_set1_epi32(-1);
+
+        for (size_t j = 0; j < compression; j++)
+        {
+            __m128i undecided = _mm_or_si128(equal_low, equal_high);
+            if (_mm_testz_si128(undecided, undecided)) break;
+
+            __m128i slice = _mm_load_si128(segment + j);
+
+            greater = _mm_or_si128(greater, _mm_and_si128(equal_low, _mm_andnot_si128(low[j], slice)));
+            equal_low = _mm_andnot_si128(_mm_xor_si128(slice, low[j]), equal_low);
+
+            less = _mm_or_si128(less, _mm_and_si128(equal_high, _mm_andnot_si128(slice, high[j])));
+            equal_high = _mm_andnot_si128(_mm_xor_si128(slice, high[j]), equal_high);
+        }
+
+        __m128i result = _mm_and_si128(_mm_or_si128(greater, equal_low), _mm_or_si128(less, equal_high));
+        hits += __store_segment_bitmap(result, std::min(segment_size, input_size - begin), output.data() + begin / 8);
+    }
+
+    return hits;
+}
+
+template std::unique_ptr<uint64_t[]> compress_bitweaving_v<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_bitweaving_v<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
@@ -0,0 +1,230 @@
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* Scalar kernels based on BMI2 (pdep/pext), compiled with BMI2 enabled (see CMakeLists.txt).
+*
+* A group of K consecutive elements is loaded with one unaligned 64 bit load and pdep deposits
+* each element into its own 64/K bit lane (and pext packs the lanes back when compressing).
+* K is the largest power of two for which the group plus its bit offset within the first byte
+* fits into 64 bits, i.e. K = 8 for compression 1-8, 4 for 9-16, 2 for 17-30 and 32, 1 for 31.
+*/
+
+static size_t gcd(size_t a, size_t b)
+{
+    while (b != 0)
+    {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static size_t bmi2_group_size(size_t compression)
+{
+    for (size_t k = 8; k > 1; k /= 2)
+    {
+        size_t group_bits = k * compression;
+        size_t max_offset = group_bits % 8 == 0 ? 0 : 8 - gcd(group_bits, 8);
+
+        if (compression <= 64 / k && group_bits + max_offset <= 64)
+        {
+            return k;
+        }
+    }
+    return 1;
+}
+
+template <unsigned K>
+struct Bmi2Lanes
+{
+    static constexpr unsigned lane_bits = 64 / K;
+    static constexpr uint64_t lane_mask = lane_bits == 64 ? ~uint64_t(0) : (uint64_t(1) << lane_bits) - 1;
+    static constexpr uint64_t lsb = ~uint64_t(0) / lane_mask; // lowest bit of each lane
+    static constexpr uint64_t msb = lsb << (lane_bits - 1);   // highest bit of each lane
+
+    uint64_t deposit_mask;
+
+    Bmi2Lanes(size_t compression) : deposit_mask(lsb * code_mask(compression)) { }
+};
+
+template <unsigned K>
+inline uint64_t __unpack_group(const uint8_t* input, size_t bit_index, Bmi2Lanes<K> const& lanes)
+{
+    uint64_t word;
+    memcpy(&word, input + bit_index / 8, sizeof(uint64_t));
+    return _pdep_u64(word >> (bit_index % 8), lanes.deposit_mask);
+}
+
+// one bit per lane (packed to the low K bits) that is set if the lane equals the key
+template <unsigned K>
+inline uint64_t __match_group(uint64_t unpacked, uint64_t key_lanes)
+{
+    typedef Bmi2Lanes<K> Lanes;
+    uint64_t x = unpacked ^ key_lanes;
+    uint64_t nonzero = ((x & ~Lanes::msb) + ~Lanes::msb) | x;
+    return _pext_u64(~nonzero, Lanes::msb);
+}
+
+template <unsigned K>
+static void __decompress_bmi2(const uint8_t* input, size_t begin, size_t end, size_t compression, int* output)
+{
+    Bmi2Lanes<K> lanes(compression);
+
+    size_t i = begin;
+    for (; i + K <= end; i += K)
+    {
+        uint64_t unpacked = __unpack_group<K>(input, i * compression, lanes);
+        for (unsigned j = 0; j < K; j++)
+        {
+            output[i + j] = (int)((unpacked >> (j * Bmi2Lanes<K>::lane_bits)) & Bmi2Lanes<K>::lane_mask);
+        }
+    }
+
+    if (i < end)
+    {
+        uint64_t unpacked = __unpack_group<K>(input, i * compression, lanes);
+        for (unsigned j = 0; i + j < end; j++)
+        {
+            output[i + j] = (int)((unpacked >> (j * Bmi2Lanes<K>::lane_bits)) & Bmi2Lanes<K>::lane_mask);
+        }
+    }
+}
+
+template <unsigned K>
+static int __scan_bmi2(uint32_t predicate_key, const uint8_t* input, size_t begin, size_t end, size_t compression, uint8_t* output)
+{
+    Bmi2Lanes<K> lanes(compression);
+    uint64_t key_lanes = Bmi2Lanes<K>::lsb * predicate_key;
+
+    int hits = 0;
+
+    for (size_t i = begin; i < end; i += 8)
+    {
+        uint64_t out = 0;
+        for (unsigned j = 0; j < 8; j += K)
+        {
+            uint64_t unpacked = __unpack_group<K>(input, (i + j) * compression, lanes);
+            out |= __match_group<K>(unpacked, key_lanes) << j;
+        }
+
+        // clear the bits of elements past the end
+        if (end - i < 8) out &= (uint64_t(1) << (end - i)) - 1;
+
+        output[i / 8] = (uint8_t)out;
+        hits += POPCNT((uint32_t)out);
+    }
+
+    return hits;
+}
+
+template <unsigned K, typename T>
+inline uint64_t __pack_group(T const* input, size_t count, uint64_t mask, Bmi2Lanes<K> const& lanes)
+{
+    uint64_t unpacked = 0;
+    for (unsigned j = 0; j < count; j++)
+    {
+        unpacked |= (uint64_t(input[j]) & mask) << (j * Bmi2Lanes<K>::lane_bits);
+    }
+    return _pext_u64(unpacked, lanes.deposit_mask);
+}
+
+template <unsigned K, typename T>
+static void __compress_bmi2(T const* input, size_t input_size, size_t compression, uint64_t* output)
+{
+    Bmi2Lanes<K> lanes(compression);
+    uint64_t mask = code_mask(compression);
+    size_t group_bits = K * compression;
+
+    // the packed groups are collected in a 64 bit word that is written once it's full
+    uint64_t word = 0;
+    size_t used_bits = 0;
+
+    for (size_t i = 0; i < input_size; i += K)
+    {
+        uint64_t packed = i + K <= input_size
+            ? __pack_group<K>(input + i, K, mask, lanes)
+            : __pack_group<K>(input + i, input_size - i, mask, lanes);
+
+        word |= packed << used_bits;
+        used_bits += group_bits;
+
+        if (used_bits >= 64)
+        {
+            *output++ = word;
+            used_bits -= 64;
+            word = used_bits == 0 ? 0 : packed >> (group_bits - used_bits);
+        }
+    }
+
+    if (used_bits > 0)
+    {
+        *output = word;
+    }
+}
+
+void decompress_tail_bmi2(const uint8_t* input, size_t begin, size_t end, size_t compression, int* output)
+{
+    switch (bmi2_group_size(compression))
+    {
+    case 8: __decompress_bmi2<8>(input, begin, end, compression, output); break;
+    case 4: __decompress_bmi2<4>(input, begin, end, compression, output); break;
+    case 2: __decompress_bmi2<2>(input, begin, end, compression, output); break;
+    default: __decompress_bmi2<1>(input, begin, end, compression, output); break;
+    }
+}
+
+int scan_tail_bmi2(uint32_t predicate_key, const uint8_t* input, size_t begin, size_t end, size_t compression, uint8_t* output)
+{
+    // keys that can't be represented with the given compression never match
+    if (predicate_key > code_mask(compression))
+    {
+        std::fill(output + begin / 8, output + (end + 7) / 8, 0);
+        return 0;
+    }
+
+    switch (bmi2_group_size(compression))
+    {
+    case 8: return __scan_bmi2<8>(predicate_key, input, begin, end, compression, output);
+    case 4: return __scan_bmi2<4>(predicate_key, input, begin, end, compression, output);
+    case 2: return __scan_bmi2<2>(predicate_key, input, begin, end, compression, output);
+    default: return __scan_bmi2<1>(predicate_key, input, begin, end, compression, output);
+    }
+}
+
+void decompress_bmi2(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    decompress_tail_bmi2((uint8_t*)input, 0, input_size, compression, output);
+}
+
+int scan_bmi2(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    return scan_tail_bmi2(predicate_key, (uint8_t*)input, 0, input_size, compression, output.data());
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_input_bmi2(std::vector<T> const& input, size_t compression)
+{
+    auto buffer_size = compressed_buffer_size(compression, input.size()) / sizeof(uint64_t);
+    auto buffer = std::make_unique<uint64_t[]>(buffer_size);
+    uint64_t* output = buffer.get();
+
+    switch (bmi2_group_size(compression))
+    {
+    case 8: __compress_bmi2<8>(input.data(), input.size(), compression, output); break;
+    case 4: __compress_bmi2<4>(input.data(), input.size(), compression, output); break;
+    case 2: __compress_bmi2<2>(input.data(), input.size(), compression, output); break;
+    default: __compress_bmi2<1>(input.data(), input.size(), compression, output); break;
+    }
+
+    return buffer;
+}
+
+template std::unique_ptr<uint64_t[]> compress_input_bmi2<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_input_bmi2<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* ByteSlice layout, 128bit kernels
+*
+* A segment holds byteslice_segment_size codes as ceil(compression / 8) byte slices of 32 bytes,
+* slice k contains the byte k of the big endian representation of every code (most significant
+* byte first), byte p of a slice belongs to the code p of the segment. The 128bit kernels process
+* the two 16 byte halves of a slice. SSE has no unsigned byte compare, so slices and constants are
+* compared with their sign bit flipped.
+*/
+
+size_t byteslice_buffer_size(size_t compression, size_t input_size)
+{
+    size_t segments = (input_size + byteslice_segment_size - 1) / byteslice_segment_size;
+    return segments * byteslice_slices(compression) * byteslice_segment_size;
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_byteslice(std::vector<T> const& input, size_t compression)
+{
+    auto buffer = std::make_unique<uint64_t[]>(byteslice_buffer_size(compression, input.size()) / sizeof(uint64_t));
+    uint8_t* bytes = (uint8_t*)buffer.get();
+
+    size_t slices = byteslice_slices(compression);
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        uint32_t element = (uint32_t)input[i] & code_mask(compression);
+        uint8_t* segment = bytes + i / byteslice_segment_size * slices * byteslice_segment_size;
+
+        for (size_t k = 0; k < slices; k++)
+        {
+            segment[k * byteslice_segment_size + i % byteslice_segment_size] = (uint8_t)(element >> (8 * (slices - 1 - k)));
+        }
+    }
+
+    return buffer;
+}
+
+void decompress_byteslice(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    const uint8_t* bytes = (const uint8_t*)input;
+
+    size_t slices = byteslice_slices(compression);
+    for (size_t i = 0; i < input_size; i++)
+    {
+        const uint8_t* segment = bytes + i / byteslice_segment_size * slices * byteslice_segment_size;
+
+        uint32_t element = 0;
+        for (size_t k = 0; k < slices; k++)
+        {
+            element = (element << 8) | segment[k * byteslice_segment_size + i % byteslice_segment_size];
+        }
+        output[i] = (int)element;
+    }
+}
+
+// byte k of the big endian representation of value with the sign bit flipped
+static __m128i __constant_slice(uint32_t value, size_t slices, size_t k)
+{
+    return _mm_set1_epi8((char)((value >> (8 * (slices - 1 - k))) ^ 0x80));
+}
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int scan_byteslice_128(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // keys that can't be represented with the given compression never match
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    const __m128i sign = _mm_set1_epi8((char)0x80);
+    size_t slices = byteslice_slices(compression);
+
+    __m128i key[4];
+    for (size_t k = 0; k < slices; k++)
+    {
+        key[k] = __constant_slice(predicate_key, slices, k);
+    }
+
+    int hits = 0;
+    for (size_t begin = 0; begin < input_size; begin += byteslice_segment_size)
+    {
+        const __m128i* segment = input + begin / byteslice_segment_size * slices * 2;
+
+        __m128i equal_low = _mm_set1_epi8(-1);
+        __m128i equal_high = _mm_set1_epi8(-1);
+        for (size_t k = 0; k < slices; k++)
+        {
+            __m128i undecided = _mm_or_si128(equal_low, equal_high);
+            if (_mm_testz_si128(undecided, undecided)) break;
+
+            __m128i slice_low = _mm_xor_si128(_mm_loadu_si128(segment + 2 * k), sign);
+            __m128i slice_high = _mm_xor_si128(_mm_loadu_si128(segment + 2 * k + 1), sign);
+            equal_low = _mm_and_si128(equal_low, _mm_cmpeq_epi8(slice_low, key[k]));
+            equal_high = _mm_and_si128(equal_high, _mm_cmpeq_epi8(slice_high, key[k]));
+        }
+
+        uint32_t bitmap = (uint32_t)_mm_movemask_epi8(equal_low) | ((uint32_t)_mm_movemask_epi8(equal_high) << 16);
+
+        // the zero padding of the last segment must not match
+        hits += POPCNT(store_segment_bitmap(bitmap, std::min(byteslice_segment_size, input_size - begin), output.data() + begin / 8));
+    }
+
+    return hits;
+}
+
+// predicate state of one 16 byte half of a segment
+struct ByteSliceRange128
+{
+    __m128i greater = _mm_setzero_si128();
+    __m128i less = _mm_setzero_si128();
+    __m128i equal_low = _mm_set1_epi8(-1);
+    __m128i equal_high = _mm_set1_epi8(-1);
+
+    void update(__m128i slice, __m128i low, __m128i high)
+    {
+        greater = _mm_or_si128(greater, _mm_and_si128(equal_low, _mm_cmpgt_epi8(slice, low)));
+        equal_low = _mm_and_si128(equal_low, _mm_cmpeq_epi8(slice, low));
+        less = _mm_or_si128(less, _mm_and_si128(equal_high, _mm_cmpgt_epi8(high, slice)));
+        equal_high = _mm_and_si128(equal_high, _mm_cmpeq_epi8(slice, high));
+    }
+
+    __m128i undecided() const
+    {
+        return _mm_or_si128(equal_low, equal_high);
+    }
+
+    uint32_t bitmap() const
+    {
+        return _mm_movemask_epi8(_mm_and_si128(_mm_or_si128(greater, equal_low), _mm_or_si128(less, equal_high)));
+    }
+};
+
+int scan_range_byteslice_128(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // clamp the predicate to the codes [0, code_mask]
+    predicate_high = std::min(predicate_high, code_mask(compression));
+    if (predicate_low > predicate_high)
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    const __m128i sign = _mm_set1_epi8((char)0x80);
+    size_t slices = byteslice_slices(compression);
+
+    __m128i low[4];
+    __m128i high[4];
+    for (size_t k = 0; k < slices; k++)
+    {
+        low[k] = __constant_slice(predicate_low, slices, k);
+        high[k] = __constant_slice(predicate_high, slices, k);
+    }
+
+    int hits = 0;
+    for (size_t begin = 0; begin < input_size; begin += byteslice_segment_size)
+    {
+        const __m128i* segment = input + begin / byteslice_segment_size * slices * 2;
+
+        ByteSliceRange128 first, second;
+        for (size_t k = 0; k < slices; k++)
+        {
+            __m128i undecided = _mm_or_si128(first.undecided(), second.undecided());
+            if (_mm_testz_si128(undecided, undecided)) break;
+
+            first.update(_mm_xor_si128(_mm_loadu_si128(segment + 2 * k), sign), low[k], high[k]);
+            second.update(_mm_xor_si128(_mm_loadu_si128(segment + 2 * k + 1), sign), low[k], high[k]);
+        }
+
+        uint32_t bitmap = first.bitmap() | (second.bitmap() << 16);
+
+        // the zero padding of the last segment must not match
+        hits += POPCNT(store_segment_bitmap(bitmap, std::min(byteslice_segment_size, input_size - begin), output.data() + begin / 8));
+    }
+
+    return hits;
+}
+
+static const bool use_avx2 = ENABLE_AVX2 && cpu_supports_avx2();
+
+int scan_byteslice(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        return scan_byteslice_256(predicate_key, input, input_size, compression, output);
+    }
+#endif
+
+    return scan_byteslice_128(predicate_key, input, input_size, compression, output);
+}
+
+int scan_range_byteslice(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        return scan_range_byteslice_256(predicate_low, predicate_high, input, input_size, compression, output);
+    }
+#endif
+
+    return scan_range_byteslice_128(predicate_low, predicate_high, input, input_size, compression, output);
+}
+
+template std::unique_ptr<uint64_t[]> compress_byteslice<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_byteslice<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* ByteSlice layout, 256bit kernels
+*
+* A slice of a segment fits one register, so a segment is decided with one compare per slice and
+* its bitmap is a single movemask.
+*/
+
+static __m256i __constant_slice(uint32_t value, size_t slices, size_t k)
+{
+    return _mm256_set1_epi8((char)((value >> (8 * (slices - 1 - k))) ^ 0x80));
+}
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int scan_byteslice_256(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    const __m256i sign = _mm256_set1_epi8((char)0x80);
+    const __m256i* segments = (const __m256i*)input;
+    size_t slices = byteslice_slices(compression);
+
+    __m256i key[4];
+    for (size_t k = 0; k < slices; k++)
+    {
+        key[k] = __constant_slice(predicate_key, slices, k);
+    }
+
+    int hits = 0;
+    for (size_t begin = 0; begin < input_size; begin += byteslice_segment_size)
+    {
+        const __m256i* segment = segments + begin / byteslice_segment_size * slices;
+
+        __m256i equal = _mm256_set1_epi8(-1);
+        for (size_t k = 0; k < slices && !_mm256_testz_si256(equal, equal); k++)
+        {
+            __m256i slice = _mm256_xor_si256(_mm256_loadu_si256(segment + k), sign);
+            equal = _mm256_and_si256(equal, _mm256_cmpeq_epi8(slice, key[k]));
+        }
+
+        uint32_t bitmap = (uint32_t)_mm256_movemask_epi8(equal);
+        hits += POPCNT(store_segment_bitmap(bitmap, std::min(byteslice_segment_size, input_size - begin), output.data() + begin / 8));
+    }
+
+    return hits;
+}
+
+int scan_range_byteslice_256(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    predicate_high = std::min(predicate_high, code_mask(compression));
+    if (predicate_low > predicate_high)
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    const __m256i sign = _mm256_set1_epi8((char)0x80);
+    const __m256i* segments = (const __m256i*)input;
+    size_t slices = byteslice_slices(compression);
+
+    __m256i low[4];
+    __m256i high[4];
+    for (size_t k = 0; k < slices; k++)
+    {
+        low[k] = __constant_slice(predicate_low, slices, k);
+        high[k] = __constant_slice(predicate_high, slices, k);
+    }
+
+    int hits = 0;
+    for (size_t begin = 0; begin < input_size; begin += byteslice_segment_size)
+    {
+        const __m256i* segment = segments + begin / byteslice_segment_size * slices;
+
+        // codes above low/below high, codes still equal to the prefix of low/high
+        __m256i greater = _mm256_setzero_si256();
+        __m256i less = _mm256_setzero_si256();
+        __m256i equal_low = _mm256_set1_epi8(-1);
+        __m256i equal_high = _mm256_set1_epi8(-1);
+
+        for (size_t k = 0; k < slices; k++)
+        {
+            __m256i undecided = _mm256_or_si256(equal_low, equal_high);
+            if (_mm256_testz_si256(undecided, undecided)) break;
+
+            __m256i slice = _mm256_xor_si256(_mm256_loadu_si256(segment + k), sign);
+
+            greater = _mm256_or_si256(greater, _mm256_and_si256(equal_low, _mm256_cmpgt_epi8(slice, low[k])));
+            equal_low = _mm256_and_si256(equal_low, _mm256_cmpeq_epi8(slice, low[k]));
+
+            less = _mm256_or_si256(less, _mm256_and_si256(equal_high, _mm256_cmpgt_epi8(high[k], slice)));
+            equal_high = _mm256_and_si256(equal_high, _mm256_cmpeq_epi8(slice, high[k]));
+        }
+
+        __m256i result = _mm256_and_si256(_mm256_or_si256(greater, equal_low), _mm256_or_si256(less, equal_high));
+        uint32_t bitmap = (uint32_t)_mm256_movemask_epi8(result);
+        hits += POPCNT(store_segment_bitmap(bitmap, std::min(byteslice_segment_size, input_size - begin), output.data() + begin / 8));
+    }
+
+    return hits;
+}
@@ -1,7 +1,45 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
 #define _mm256_loadu2_m128i(hi, lo) (_mm256_set_m128i(_mm_loadu_si128(hi), _mm_loadu_si128(lo)))
 
+// The helpers are included by the SSE and the AVX2 translation units, which are compiled with different
+// instruction sets. Internal linkage keeps the linker from merging the copies (an AVX2 copy must never be
+// called on the SSE path).
+namespace {
+
+/*
+* The shuffle based kernels gather a 4 byte window per element. An element fits into that window
+* as long as its bit padding plus the compression does not exceed 32 bits.
+*/
+constexpr bool fits_shuffle_window(size_t compression)
+{
+    size_t max_padding = 0;
+    for (size_t i = 0; i < 8; i++)
+    {
+        max_padding = std::max(max_padding, (compression * i) % 8);
+    }
+    return compression >= 1 && compression + max_padding <= 32;
+}
+
+constexpr uint32_t code_mask(size_t compression)
+{
+    return compression >= 32 ? 0xFFFFFFFFu : (uint32_t(1) << compression) - 1;
+}
+
+// reads a single element with an unaligned 8 byte load (compression 1-57), the input must be padded
+inline uint64_t extract_element(const uint8_t* input, size_t index, size_t compression)
+{
+    size_t bit_index = index * compression;
+    uint64_t word;
+    memcpy(&word, &input[bit_index / 8], sizeof(word));
+    return (word >> (bit_index % 8)) & ((uint64_t(1) << compression) - 1);
+}
+
 inline void generate_shuffle_mask_128(int compression, __m128i shuffle_mask[2])
 {
     size_t input_offset[8];
@@ -38,15 +76,15 @@ inline void generate_shift_masks_128(int compression, __m128i shift_mask[2])
     }
 
     shift_mask[0] = _mm_setr_epi32(
-        1 << (free_bits - padding[0]),
-        1 << (free_bits - padding[1]),
-        1 << (free_bits - padding[2]),
-        1 << (free_bits - padding[3]));
+        uint32_t(1) << (free_bits - padding[0]),
+        uint32_t(1) << (free_bits - padding[1]),
+        uint32_t(1) << (free_bits - padding[2]),
+        uint32_t(1) << (free_bits - padding[3]));
     shift_mask[1] = _mm_setr_epi32(
-        1 << (free_bits - padding[4]),
-        1 << (free_bits - padding[5]),
-        1 << (free_bits - padding[6]),
-        1 << (free_bits - padding[7]));
+        uint32_t(1) << (free_bits - padding[4]),
+        uint32_t(1) << (free_bits - padding[5]),
+        uint32_t(1) << (free_bits - padding[6]),
+        uint32_t(1) << (free_bits - padding[7]));
 }
 
 inline void generate_clean_masks_128(int compression, __m128i clean_mask[2])
@@ -58,15 +96,15 @@ inline void generate_clean_masks_128(int compression, __m128i clean_mask[2])
     }
 
     clean_mask[0] = _mm_setr_epi32(
-        ((1 << compression) - 1) << padding[0],
-        ((1 << compression) - 1) << padding[1],
-        ((1 << compression) - 1) << padding[2],
-        ((1 << compression) - 1) << padding[3]);
+        code_mask(compression) << padding[0],
+        code_mask(compression) << padding[1],
+        code_mask(compression) << padding[2],
+        code_mask(compression) << padding[3]);
     clean_mask[1] = _mm_setr_epi32(
-        ((1 << compression) - 1) << padding[4],
-        ((1 << compression) - 1) << padding[5],
-        ((1 << compression) - 1) << padding[6],
-        ((1 << compression) - 1) << padding[7]);
+        code_mask(compression) << padding[4],
+        code_mask(compression) << padding[5],
+        code_mask(compression) << padding[6],
+        code_mask(compression) << padding[7]);
 }
 
 inline void generate_predicate_masks_128(int compression, int predicate_key, __m128i predicate[2])
@@ -78,18 +116,187 @@ inline void generate_predicate_masks_128(int compression, int predicate_key, __m
     }
 
     predicate[0] = _mm_setr_epi32(
-        predicate_key << padding[0],
-        predicate_key << padding[1],
-        predicate_key << padding[2],
-        predicate_key << padding[3]);
+        uint32_t(predicate_key) << padding[0],
+        uint32_t(predicate_key) << padding[1],
+        uint32_t(predicate_key) << padding[2],
+        uint32_t(predicate_key) << padding[3]);
     predicate[1] = _mm_setr_epi32(
-        predicate_key << padding[4],
-        predicate_key << padding[5],
-        predicate_key << padding[6],
-        predicate_key << padding[7]);
+        uint32_t(predicate_key) << padding[4],
+        uint32_t(predicate_key) << padding[5],
+        uint32_t(predicate_key) << padding[6],
+        uint32_t(predicate_key) << padding[7]);
+}
+
+// reads a single element of up to 64 bits with two unaligned 8 byte loads, the input must be padded
+inline uint64_t extract_element_64(const uint8_t* input, size_t index, size_t compression)
+{
+    size_t bit_index = index * compression;
+    size_t padding = bit_index % 8;
+
+    uint64_t words[2];
+    memcpy(words, &input[bit_index / 8], sizeof(words));
+
+    uint64_t element = words[0] >> padding;
+    if (padding != 0)
+    {
+        element |= words[1] << (64 - padding);
+    }
+    return compression >= 64 ? element : element & ((uint64_t(1) << compression) - 1);
+}
+
+// 64 bit version of fits_shuffle_window: an element plus its bit padding fits into 8 bytes
+constexpr bool fits_shuffle_window_64(size_t compression)
+{
+    size_t max_padding = 0;
+    for (size_t i = 0; i < 8; i++)
+    {
+        max_padding = std::max(max_padding, (compression * i) % 8);
+    }
+    return compression >= 1 && compression + max_padding <= 64;
+}
+
+/*
+* Masks for wide elements (compression + padding > 32). Each element is assembled from its first byte
+* (low) and the 4 following bytes (high): element = (high << (8 - padding)) | (low >> padding), where both
+* shifts are done with the same multiplier 1 << (8 - padding) and a fixed right shift by 8 for the low part.
+* Works for every compression up to 32.
+*/
+inline void generate_wide_shuffle_masks_128(int compression, __m128i shuffle_mask_low[2], __m128i shuffle_mask_high[2])
+{
+    int8_t low[2][16];
+    int8_t high[2][16];
+
+    size_t correction = (compression * 4) / 8;
+    for (size_t i = 0; i < 8; i++)
+    {
+        size_t input_offset = (compression * i) / 8 - (i < 4 ? 0 : correction);
+        size_t lane = i % 4;
+
+        low[i / 4][4 * lane] = input_offset;
+        for (size_t j = 1; j < 4; j++)
+        {
+            low[i / 4][4 * lane + j] = -128; // zero
+        }
+
+        // the byte after the 16 byte window is only referenced if the element doesn't need it
+        for (size_t j = 0; j < 4; j++)
+        {
+            size_t index = input_offset + 1 + j;
+            high[i / 4][4 * lane + j] = index < 16 ? index : -128;
+        }
+    }
+
+    shuffle_mask_low[0] = _mm_loadu_si128((__m128i*)low[0]);
+    shuffle_mask_low[1] = _mm_loadu_si128((__m128i*)low[1]);
+    shuffle_mask_high[0] = _mm_loadu_si128((__m128i*)high[0]);
+    shuffle_mask_high[1] = _mm_loadu_si128((__m128i*)high[1]);
+}
+
+inline void generate_wide_shift_masks_128(int compression, __m128i shift_mask[2])
+{
+    size_t padding[8];
+    for (size_t i = 0; i < 8; i++)
+    {
+        padding[i] = (compression * i) % 8;
+    }
+
+    shift_mask[0] = _mm_setr_epi32(
+        1 << (8 - padding[0]),
+        1 << (8 - padding[1]),
+        1 << (8 - padding[2]),
+        1 << (8 - padding[3]));
+    shift_mask[1] = _mm_setr_epi32(
+        1 << (8 - padding[4]),
+        1 << (8 - padding[5]),
+        1 << (8 - padding[6]),
+        1 << (8 - padding[7]));
+}
+
+inline __m128i unpack_wide_128(__m128i source, __m128i shuffle_mask_low, __m128i shuffle_mask_high, __m128i shift_mask, __m128i and_mask)
+{
+    __m128i low = _mm_mullo_epi32(_mm_shuffle_epi8(source, shuffle_mask_low), shift_mask);
+    __m128i high = _mm_mullo_epi32(_mm_shuffle_epi8(source, shuffle_mask_high), shift_mask);
+    __m128i c = _mm_or_si128(high, _mm_srli_epi32(low, 8));
+    return _mm_and_si128(c, and_mask);
+}
+
+/*
+* 16 bit lanes (compression 1-16): a group of 8 elements spans exactly compression bytes, so every group
+* starts at a byte boundary and one set of masks serves all groups.
+* If an element and its bit padding fit into 16 bits, the lane gathers its two bytes and the element is
+* moved to the top of the lane by a multiplication and shifted down (like the 32 bit kernels).
+* Otherwise the lane is assembled from its first byte and the two following bytes (like the wide kernels).
+*/
+constexpr bool fits_16bit_lane(size_t compression)
+{
+    size_t max_padding = 0;
+    for (size_t i = 0; i < 8; i++)
+    {
+        max_padding = std::max(max_padding, (compression * i) % 8);
+    }
+    return compression + max_padding <= 16;
+}
+
+struct Masks16bit
+{
+    bool narrow;
+    __m128i shuffle_mask;      // narrow: bytes b and b + 1, wide: byte b
+    __m128i shuffle_mask_high; // wide: bytes b + 1 and b + 2
+    __m128i shift_mask;        // narrow: 2^(16 - compression - padding), wide: 2^(8 - padding)
+    __m128i and_mask;
+
+    // byte_offset moves the group, e.g. to the second group of a register for the 8 bit kernels
+    Masks16bit(size_t compression, size_t byte_offset = 0) : narrow(fits_16bit_lane(compression))
+    {
+        int8_t shuffle[16], shuffle_high[16];
+        int16_t shift[8];
+
+        for (size_t i = 0; i < 8; i++)
+        {
+            size_t bit = i * compression;
+            int8_t byte = bit / 8 + byte_offset;
+            size_t padding = bit % 8;
+
+            if (narrow)
+            {
+                shuffle[2 * i] = byte;
+                shuffle[2 * i + 1] = byte + 1 < 16 ? byte + 1 : -128;
+                shift[i] = 1 << (16 - compression - padding);
+            }
+            else
+            {
+                shuffle[2 * i] = byte;
+                shuffle[2 * i + 1] = -128;
+                shuffle_high[2 * i] = byte + 1;
+                shuffle_high[2 * i + 1] = byte + 2 < 16 ? byte + 2 : -128;
+                shift[i] = 1 << (8 - padding);
+            }
+        }
+
+        shuffle_mask = _mm_loadu_si128((__m128i*)shuffle);
+        shuffle_mask_high = narrow ? shuffle_mask : _mm_loadu_si128((__m128i*)shuffle_high);
+        shift_mask = _mm_loadu_si128((__m128i*)shift);
+        and_mask = _mm_set1_epi16((int16_t)code_mask(compression));
+    }
+};
+
+// unpacks the 8 elements of the group starting at source
+inline __m128i unpack_16bit_128(__m128i source, size_t compression, Masks16bit const& masks)
+{
+    if (masks.narrow)
+    {
+        __m128i b = _mm_shuffle_epi8(source, masks.shuffle_mask);
+        __m128i c = _mm_mullo_epi16(b, masks.shift_mask);
+        return _mm_srli_epi16(c, 16 - compression);
+    }
+
+    __m128i low = _mm_mullo_epi16(_mm_shuffle_epi8(source, masks.shuffle_mask), masks.shift_mask);
+    __m128i high = _mm_mullo_epi16(_mm_shuffle_epi8(source, masks.shuffle_mask_high), masks.shift_mask);
+    return _mm_and_si128(_mm_or_si128(high, _mm_srli_epi16(low, 8)), masks.and_mask);
 }
 
 #ifdef __AVX__
+// the upper lane is expected to be loaded starting at the byte of element 4 (see load_256_halves)
 inline __m256i generate_shuffle_mask_256(int compression)
 {
     size_t input_offset[8];
@@ -97,6 +304,11 @@ inline __m256i generate_shuffle_mask_256(int compression)
     {
         input_offset[i] = (compression * i) / 8;
     }
+    size_t correction = input_offset[4];
+    for (size_t i = 4; i < 8; i++)
+    {
+        input_offset[i] -= correction;
+    }
 
     return _mm256_setr_epi8(
         input_offset[0], input_offset[0] + 1, input_offset[0] + 2, input_offset[0] + 3,
@@ -110,6 +322,13 @@ inline __m256i generate_shuffle_mask_256(int compression)
         input_offset[7], input_offset[7] + 1, input_offset[7] + 2, input_offset[7] + 3);
 }
 
+// loads the 16 bytes of elements 0-3 into the lower and the 16 bytes of elements 4-7 into the upper lane,
+// where next points to the byte of element 0 (which must be a multiple of 8)
+inline __m256i load_256_halves(uint8_t* next, size_t compression)
+{
+    return _mm256_loadu2_m128i((__m128i*)&next[(4 * compression) / 8], (__m128i*)next);
+}
+
 inline __m256i generate_shift_mask_256(int compression)
 {
     size_t free_bits = 32 - compression;
@@ -121,14 +340,14 @@ inline __m256i generate_shift_mask_256(int compression)
     }
 
     return _mm256_setr_epi32(
-        1 << (free_bits - padding[0]),
-        1 << (free_bits - padding[1]),
-        1 << (free_bits - padding[2]),
-        1 << (free_bits - padding[3]),
-        1 << (free_bits - padding[4]),
-        1 << (free_bits - padding[5]),
-        1 << (free_bits - padding[6]),
-        1 << (free_bits - padding[7]));
+        uint32_t(1) << (free_bits - padding[0]),
+        uint32_t(1) << (free_bits - padding[1]),
+        uint32_t(1) << (free_bits - padding[2]),
+        uint32_t(1) << (free_bits - padding[3]),
+        uint32_t(1) << (free_bits - padding[4]),
+        uint32_t(1) << (free_bits - padding[5]),
+        uint32_t(1) << (free_bits - padding[6]),
+        uint32_t(1) << (free_bits - padding[7]));
 }
 
 inline __m256i generate_clean_mask_256(int compression)
@@ -140,14 +359,14 @@ inline __m256i generate_clean_mask_256(int compression)
     }
 
     return _mm256_setr_epi32(
-        ((1 << compression) - 1) << padding[0],
-        ((1 << compression) - 1) << padding[1],
-        ((1 << compression) - 1) << padding[2],
-        ((1 << compression) - 1) << padding[3],
-        ((1 << compression) - 1) << padding[4],
-        ((1 << compression) - 1) << padding[5],
-        ((1 << compression) - 1) << padding[6],
-        ((1 << compression) - 1) << padding[7]);
+        code_mask(compression) << padding[0],
+        code_mask(compression) << padding[1],
+        code_mask(compression) << padding[2],
+        code_mask(compression) << padding[3],
+        code_mask(compression) << padding[4],
+        code_mask(compression) << padding[5],
+        code_mask(compression) << padding[6],
+        code_mask(compression) << padding[7]);
 }
 
 inline __m256i generate_predicate_mask_256(int compression, int predicate_key)
@@ -159,13 +378,119 @@ inline __m256i generate_predicate_mask_256(int compression, int predicate_key)
     }
 
     return _mm256_setr_epi32(
-        predicate_key << padding[0],
-        predicate_key << padding[1],
-        predicate_key << padding[2],
-        predicate_key << padding[3],
-        predicate_key << padding[4],
-        predicate_key << padding[5],
-        predicate_key << padding[6],
-        predicate_key << padding[7]);
-}
-#endif
\ No newline at end of file
+        uint32_t(predicate_key) << padding[0],
+        uint32_t(predicate_key) << padding[1],
+        uint32_t(predicate_key) << padding[2],
+        uint32_t(predicate_key) << padding[3],
+        uint32_t(predicate_key) << padding[4],
+        uint32_t(predicate_key) << padding[5],
+        uint32_t(predicate_key) << padding[6],
+        uint32_t(predicate_key) << padding[7]);
+}
+inline __m256i unpack_wide_256(__m256i source, __m256i shuffle_mask_low, __m256i shuffle_mask_high, __m256i shift_mask, __m256i and_mask)
+{
+    __m256i low = _mm256_mullo_epi32(_mm256_shuffle_epi8(source, shuffle_mask_low), shift_mask);
+    __m256i high = _mm256_mullo_epi32(_mm256_shuffle_epi8(source, shuffle_mask_high), shift_mask);
+    __m256i c = _mm256_or_si256(high, _mm256_srli_epi32(low, 8));
+    return _mm256_and_si256(c, and_mask);
+}
+
+#ifdef __AVX2__
+/*
+* Full 32 byte loads (compression 1-26, 28, 32): each register holds 8 elements, a cross-lane permute
+* moves the dwords of elements 4-7 into the upper lane. One load covers 16 elements for compression up
+* to 16, otherwise the second register is loaded from the next 8 elements (compression bytes later).
+*/
+struct PermuteMasks256
+{
+    size_t load_offset[2];
+    __m256i permute_mask[2];
+    __m256i shuffle_mask[2];
+    __m256i shift_mask[2];
+    __m256i and_mask;
+
+    PermuteMasks256(size_t compression)
+    {
+        bool shared_load = compression <= 16;
+
+        for (size_t r = 0; r < 2; r++)
+        {
+            size_t first = shared_load ? 8 * r : 0; // first element of the register within the load
+            load_offset[r] = shared_load ? 0 : r * compression;
+
+            int32_t permute[8], shift[8];
+            int8_t shuffle[32];
+
+            for (size_t lane = 0; lane < 2; lane++)
+            {
+                size_t lane_byte = ((first + 4 * lane) * compression) / 8;
+                size_t dword = lane_byte / 4;
+
+                for (size_t i = 0; i < 4; i++)
+                {
+                    permute[4 * lane + i] = (dword + i) % 8;
+
+                    size_t bit = (first + 4 * lane + i) * compression;
+                    size_t byte = bit / 8 - 4 * dword;
+                    for (size_t k = 0; k < 4; k++)
+                    {
+                        shuffle[16 * lane + 4 * i + k] = byte + k < 16 ? byte + k : -128;
+                    }
+                    shift[4 * lane + i] = bit % 8;
+                }
+            }
+
+            permute_mask[r] = _mm256_loadu_si256((__m256i*)permute);
+            shuffle_mask[r] = _mm256_loadu_si256((__m256i*)shuffle);
+            shift_mask[r] = _mm256_loadu_si256((__m256i*)shift);
+        }
+
+        and_mask = _mm256_set1_epi32(code_mask(compression));
+    }
+};
+
+// unpacks register r (elements 8 * r to 8 * r + 7) of the 16 elements starting at input
+inline __m256i unpack_permute_256(const uint8_t* input, PermuteMasks256 const& masks, size_t r)
+{
+    __m256i source = _mm256_loadu_si256((__m256i*)&input[masks.load_offset[r]]);
+    __m256i a = _mm256_permutevar8x32_epi32(source, masks.permute_mask[r]);
+    __m256i b = _mm256_shuffle_epi8(a, masks.shuffle_mask[r]);
+    __m256i c = _mm256_srlv_epi32(b, masks.shift_mask[r]);
+    return _mm256_and_si256(c, masks.and_mask);
+}
+
+// same as unpack_16bit_128, the lower lane holds the first group, the upper lane the second one
+inline __m256i unpack_16bit_256(__m256i source, size_t compression, Masks16bit const& masks)
+{
+    __m256i shuffle_mask = _mm256_broadcastsi128_si256(masks.shuffle_mask);
+    __m256i shift_mask = _mm256_broadcastsi128_si256(masks.shift_mask);
+
+    if (masks.narrow)
+    {
+        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+        __m256i c = _mm256_mullo_epi16(b, shift_mask);
+        return _mm256_srli_epi16(c, 16 - compression);
+    }
+
+    __m256i low = _mm256_mullo_epi16(_mm256_shuffle_epi8(source, shuffle_mask), shift_mask);
+    __m256i high = _mm256_mullo_epi16(_mm256_shuffle_epi8(source, _mm256_broadcastsi128_si256(masks.shuffle_mask_high)), shift_mask);
+    return _mm256_and_si256(_mm256_or_si256(high, _mm256_srli_epi16(low, 8)), _mm256_broadcastsi128_si256(masks.and_mask));
+}
+
+#endif
+
+#endif
+
+// writes the first count bits (up to 32) of a segment bitmap and clears the bits behind them in the result
+inline uint32_t store_segment_bitmap(uint32_t bitmap, size_t count, uint8_t* output)
+{
+    if (count < 32)
+    {
+        bitmap &= (uint32_t(1) << count) - 1;
+    }
+
+    memcpy(output, &bitmap, (count + 7) / 8);
+    return bitmap;
+}
+
+} // namespace
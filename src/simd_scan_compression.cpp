@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cstring>
+
 #include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
 #include "util.hpp"
 
 // original compression function (with some bug fixes...) for reference
@@ -52,53 +56,221 @@ void* compress_9bit_input_original(std::vector<uint16_t>& input)
 
 std::unique_ptr<uint64_t[]> compress_9bit_input(std::vector<uint16_t>& input)
 {
-    auto element_size = 8 * sizeof(uint64_t);
-    auto compression = BITS_NEEDED;
+    return compress_128(input, BITS_NEEDED);
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_input(std::vector<T> const& input, size_t compression)
+{
+    const size_t element_size = 8 * sizeof(uint64_t);
     auto buffer_size = compressed_buffer_size(compression, input.size()) / sizeof(uint64_t);
     auto buffer = std::make_unique<uint64_t[]>(buffer_size);
 
-    // these are for making the ptr align to 16/32 byte boundaries,
-    // turns out it makes no difference in performance though.
-    //auto buffer = std::unique_ptr<uint64_t[]>((uint64_t*) new __m128i[array_size / 2]);
-    //auto buffer = std::unique_ptr<uint64_t[]>((uint64_t*) new __m256i[array_size / 4]);
-    //auto buffer = std::unique_ptr<uint64_t[]>((uint64_t*) _mm_malloc(array_size * sizeof(uint64_t), 256));
+    uint64_t mask = compression >= element_size ? ~uint64_t(0) : (uint64_t(1) << compression) - 1;
 
-    int remaining_buffer_size = element_size;
-    int idx_ = 0;
     for (size_t i = 0; i < input.size(); i++)
     {
-        uint64_t tmp_buffer = 0;
-        tmp_buffer = tmp_buffer | input[i];
-        tmp_buffer = tmp_buffer << (i * compression); // TODO undefined behaviour?
-        buffer[idx_] = buffer[idx_] | tmp_buffer;
-        remaining_buffer_size -= compression;
+        uint64_t element = uint64_t(input[i]) & mask;
+        size_t bit_index = i * compression;
+        size_t idx_ = bit_index / element_size;
+        size_t offset = bit_index % element_size;
 
-        if (remaining_buffer_size == 0)
+        buffer[idx_] |= element << offset;
+
+        // element overflows into the next 64 bit block
+        if (offset + compression > element_size)
         {
-            idx_++;
-            remaining_buffer_size = element_size;
-            continue;
+            buffer[idx_ + 1] |= element >> (element_size - offset);
         }
-        else if (remaining_buffer_size < compression)
+    }
+
+    return buffer;
+}
+
+/*
+* SIMD compression (SSE4.1; 128bit), the inverse of the unpack kernels
+*
+* Each step packs 8 elements, which always fill exactly compression bytes:
+* 1. the odd 32 bit lanes are shifted down next to the even ones, giving 2 elements per 64 bit lane
+* 2. the high 64 bit lane is shifted across the lane boundary, giving 4 elements per register
+* 3. the second register (elements 4-7) is shifted by the remaining 0 or 4 bits and moved to its
+*    byte offset with a shuffle, the part that doesn't fit the first 16 bytes goes to a second register
+* Bytes behind the packed elements are zero, so the next step can simply overwrite them.
+*/
+
+inline __m128i __load_compression_input(uint16_t const* input)
+{
+    return _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i const*)input));
+}
+
+inline __m128i __load_compression_input(uint32_t const* input)
+{
+    return _mm_loadu_si128((__m128i const*)input);
+}
+
+inline __m128i __pack_128_step(__m128i elements, __m128i pair_shift, __m128i lane_shift_left, __m128i lane_shift_right)
+{
+    const __m128i low_32bit = _mm_set1_epi64x(0xFFFFFFFF);
+
+    __m128i pairs = _mm_or_si128(
+        _mm_and_si128(elements, low_32bit),
+        _mm_srl_epi64(_mm_andnot_si128(low_32bit, elements), pair_shift));
+
+    __m128i low = _mm_move_epi64(pairs);
+    __m128i high_to_low = _mm_sll_epi64(_mm_unpackhi_epi64(pairs, _mm_setzero_si128()), lane_shift_left);
+    __m128i high = _mm_srl_epi64(_mm_unpackhi_epi64(_mm_setzero_si128(), pairs), lane_shift_right);
+
+    return _mm_or_si128(low, _mm_or_si128(high_to_low, high));
+}
+
+// packs exactly the bytes of the given elements, the output has to start at a byte boundary
+template <typename T>
+static void __compress_tail(T const* input, size_t count, size_t compression, uint8_t* output)
+{
+    uint64_t word = 0;
+    size_t used_bits = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        word |= (uint64_t(input[i]) & code_mask(compression)) << used_bits;
+        used_bits += compression;
+
+        while (used_bits >= 8)
         {
-            i++;
-            if (i == input.size()) break;
+            *output++ = (uint8_t)word;
+            word >>= 8;
+            used_bits -= 8;
+        }
+    }
 
-            tmp_buffer = 0;
-            tmp_buffer = tmp_buffer | input[i];
-            tmp_buffer = tmp_buffer << (element_size - remaining_buffer_size);
-            buffer[idx_] = buffer[idx_] | tmp_buffer;
+    if (used_bits > 0)
+    {
+        *output = (uint8_t)word;
+    }
+}
 
-            idx_++;
+// packs the first vectorized_size elements (a multiple of 8) with SIMD and the rest with __compress_tail,
+// the SIMD stores write up to 32 zero bytes behind the packed elements
+template <bool WIDE, typename T>
+static void __compress_128(T const* input, size_t input_size, size_t vectorized_size, size_t compression, uint8_t* output)
+{
+    const __m128i mask = _mm_set1_epi32(code_mask(compression));
+    const __m128i pair_shift = _mm_cvtsi32_si128(32 - compression);
+    const __m128i lane_shift_left = _mm_cvtsi32_si128(2 * compression);
+    const __m128i lane_shift_right = _mm_cvtsi32_si128(64 - 2 * compression);
 
-            // Second half
-            tmp_buffer = 0;
-            tmp_buffer = tmp_buffer | input[i];
-            tmp_buffer = tmp_buffer >> remaining_buffer_size;
-            buffer[idx_] = buffer[idx_] | tmp_buffer;
-            remaining_buffer_size = element_size - (compression - remaining_buffer_size);
+    // elements 4-7 start at bit 4 * compression
+    size_t second_bits = (4 * compression) % 8;
+    size_t second_offset = (4 * compression) / 8;
+    const __m128i second_shift_left = _mm_cvtsi32_si128(second_bits);
+    const __m128i second_shift_right = _mm_cvtsi32_si128(64 - second_bits);
+
+    alignas(16) int8_t shuffle_low[16];
+    alignas(16) int8_t shuffle_high[16];
+    for (size_t i = 0; i < 16; i++)
+    {
+        shuffle_low[i] = i >= second_offset ? i - second_offset : -1;
+        shuffle_high[i] = i + 16 - second_offset < 16 ? i + 16 - second_offset : -1;
+    }
+    const __m128i second_mask_low = _mm_load_si128((__m128i*)shuffle_low);
+    const __m128i second_mask_high = _mm_load_si128((__m128i*)shuffle_high);
+
+    for (size_t i = 0; i < vectorized_size; i += 8)
+    {
+        __m128i first = __pack_128_step(_mm_and_si128(__load_compression_input(input + i), mask), pair_shift, lane_shift_left, lane_shift_right);
+        __m128i second = __pack_128_step(_mm_and_si128(__load_compression_input(input + i + 4), mask), pair_shift, lane_shift_left, lane_shift_right);
+
+        second = _mm_or_si128(_mm_sll_epi64(second, second_shift_left), _mm_srl_epi64(_mm_slli_si128(second, 8), second_shift_right));
+
+        _mm_storeu_si128((__m128i*)output, _mm_or_si128(first, _mm_shuffle_epi8(second, second_mask_low)));
+        if (WIDE)
+        {
+            _mm_storeu_si128((__m128i*)(output + 16), _mm_shuffle_epi8(second, second_mask_high));
         }
+
+        output += compression;
+    }
+
+    __compress_tail(input + vectorized_size, input_size - vectorized_size, compression, output);
+}
+
+template <typename T>
+static void __compress_128(T const* input, size_t input_size, size_t vectorized_size, size_t compression, uint8_t* output)
+{
+    if (compression <= 16)
+    {
+        __compress_128<false>(input, input_size, vectorized_size, compression, output);
+    }
+    else
+    {
+        __compress_128<true>(input, input_size, vectorized_size, compression, output);
+    }
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_128(std::vector<T> const& input, size_t compression)
+{
+    auto buffer_size = compressed_buffer_size(compression, input.size()) / sizeof(uint64_t);
+    auto buffer = std::make_unique<uint64_t[]>(buffer_size);
+
+    compress_128_into(input.data(), input.size(), compression, (uint8_t*)buffer.get());
+
+    return buffer;
+}
+
+template <typename T>
+void compress_128_into(T const* input, size_t input_size, size_t compression, uint8_t* output)
+{
+    __compress_128(input, input_size, input_size & ~size_t(7), compression, output);
+}
+
+/*
+* Multi-threaded compression
+*
+* The input is split into chunks of a multiple of 8 elements, so every chunk starts at a byte
+* boundary and no two chunks share a byte. A chunk stops its SIMD loop early enough that the
+* stores behind the packed elements stay within its own bytes, the rest is packed exactly.
+* The buffer isn't zero initialized up front, the chunks write all bytes up to the padding.
+*/
+
+static const size_t compression_chunk_size = 1 << 16;
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_128_parallel(std::vector<T> const& input, size_t compression)
+{
+    size_t input_size = input.size();
+    auto buffer_size = compressed_buffer_size(compression, input_size) / sizeof(uint64_t);
+    auto buffer = std::unique_ptr<uint64_t[]>(new uint64_t[buffer_size]);
+    uint8_t* output = (uint8_t*)buffer.get();
+
+    // up to 32 bytes written behind each step, i.e. ceil(32 / compression) steps of 8 elements
+    size_t overlapping_size = 8 * ((32 + compression - 1) / compression);
+    int chunk_count = (int)((input_size + compression_chunk_size - 1) / compression_chunk_size);
+
+    #pragma omp parallel for schedule(static)
+    for (int chunk = 0; chunk < chunk_count; chunk++)
+    {
+        size_t begin = chunk * compression_chunk_size;
+        size_t end = std::min(begin + compression_chunk_size, input_size);
+        size_t size = end - begin;
+        size_t vectorized_size = size > overlapping_size ? (size - overlapping_size) & ~size_t(7) : 0;
+
+        __compress_128(input.data() + begin, size, vectorized_size, compression, output + begin * compression / 8);
     }
 
+    size_t packed_bytes = (input_size * compression + 7) / 8;
+    memset(output + packed_bytes, 0, buffer_size * sizeof(uint64_t) - packed_bytes);
+
     return buffer;
 }
+
+template std::unique_ptr<uint64_t[]> compress_128<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_128<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
+template void compress_128_into<uint16_t>(uint16_t const* input, size_t input_size, size_t compression, uint8_t* output);
+template void compress_128_into<uint32_t>(uint32_t const* input, size_t input_size, size_t compression, uint8_t* output);
+template std::unique_ptr<uint64_t[]> compress_128_parallel<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_128_parallel<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
+
+template std::unique_ptr<uint64_t[]> compress_input<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_input<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_input<uint64_t>(std::vector<uint64_t> const& input, size_t compression);
@@ -3,14 +3,14 @@
 #include "util.hpp"
 #include "profiling.hpp"
 
-void decompress_unvectorized(__m128i* input, size_t input_size, int* output)
+void decompress_unvectorized(__m128i* input, size_t input_size, size_t compression, int* output)
 {
     uint64_t* in = reinterpret_cast<uint64_t*>(input);
-    auto bits_needed = BITS_NEEDED;
+    auto bits_needed = compression;
     auto mem_size = bits_needed * input_size;
-    int array_size = ceil((double)mem_size / 64);
+    size_t array_size = ceil((double)mem_size / 64);
 
-    uint64_t mask = (1 << bits_needed) - 1;
+    uint64_t mask = (uint64_t(1) << bits_needed) - 1;
 
     uint64_t current = 0;
     size_t overflow_bits = 0;
@@ -24,7 +24,7 @@ void decompress_unvectorized(__m128i* input, size_t input_size, int* output)
         size_t unread_bits = 64 - overflow_bits;
         while (unread_bits >= bits_needed)
         {
-            uint16_t decompressed_element = current & mask;
+            uint32_t decompressed_element = current & mask;
             output[oi++] = decompressed_element;
 
             if (oi == input_size)
@@ -42,9 +42,14 @@ void decompress_unvectorized(__m128i* input, size_t input_size, int* output)
             uint64_t next = in[i + 1];
             current = current | (next << unread_bits);
 
-            uint16_t decompressed_element = current & mask;
+            uint32_t decompressed_element = current & mask;
             output[oi++] = decompressed_element;
 
+            if (oi == input_size)
+            {
+                return;
+            }
+
             overflow_bits = bits_needed - unread_bits;
         }
         else 
@@ -54,9 +59,8 @@ void decompress_unvectorized(__m128i* input, size_t input_size, int* output)
     }
 }
 
-void decompress_128_sweep(__m128i* input, size_t input_size, int* output)
+void decompress_128_sweep(__m128i* input, size_t input_size, size_t compression, int* output)
 {
-    size_t compression = BITS_NEEDED;
     size_t free_bits = 32 - compression; // most significant bits in result values that must be 0
 
     __m128i source = _mm_loadu_si128(input);
@@ -91,10 +95,10 @@ void decompress_128_sweep(__m128i* input, size_t input_size, int* output)
         };
 
         __m128i mult = _mm_setr_epi32(
-            1 << (free_bits - padding[0]),
-            1 << (free_bits - padding[1]),
-            1 << (free_bits - padding[2]),
-            1 << (free_bits - padding[3]));
+            uint32_t(1) << (free_bits - padding[0]),
+            uint32_t(1) << (free_bits - padding[1]),
+            uint32_t(1) << (free_bits - padding[2]),
+            uint32_t(1) << (free_bits - padding[3]));
 
         __m128i c = _mm_mullo_epi32(b, mult);
 
@@ -112,14 +116,13 @@ void decompress_128_sweep(__m128i* input, size_t input_size, int* output)
             // TODO uses unaligned loads --> possibly slow?
             total_processed_bytes = output_index * compression / 8;
             source = _mm_loadu_si128((__m128i*)&((uint8_t*)input)[total_processed_bytes]);
-            unread_bits = 128;
+            unread_bits = 128 - (output_index * compression % 8); // first element may not start at a byte boundary
         }
     }
 }
 
-void decompress_128_nosweep(__m128i* input, size_t input_size, int* output)
+void decompress_128_nosweep(__m128i* input, size_t input_size, size_t compression, int* output)
 {
-    size_t compression = BITS_NEEDED;
     size_t free_bits = 32 - compression; // most significant bits in result values that must be 0
 
     __m128i source = _mm_loadu_si128(input);
@@ -153,10 +156,10 @@ void decompress_128_nosweep(__m128i* input, size_t input_size, int* output)
         };
 
         __m128i mult = _mm_setr_epi32(
-            1 << (free_bits - padding[0]),
-            1 << (free_bits - padding[1]),
-            1 << (free_bits - padding[2]),
-            1 << (free_bits - padding[3]));
+            uint32_t(1) << (free_bits - padding[0]),
+            uint32_t(1) << (free_bits - padding[1]),
+            uint32_t(1) << (free_bits - padding[2]),
+            uint32_t(1) << (free_bits - padding[3]));
 
         __m128i c = _mm_mullo_epi32(b, mult);
 
@@ -234,9 +237,8 @@ void decompress_128_9bit(__m128i* input, size_t input_size, int* output)
     }
 }
 
-void decompress_128(__m128i* input, size_t input_size, int* output)
+void decompress_128(__m128i* input, size_t input_size, size_t compression, int* output)
 {
-    size_t compression = BITS_NEEDED;
     size_t free_bits = 32 - compression; // most significant bits in result values that must be 0
 
     __m128i source = _mm_loadu_si128(input);
@@ -270,9 +272,8 @@ void decompress_128(__m128i* input, size_t input_size, int* output)
     }
 }
 
-void decompress_128_unrolled(__m128i* input, size_t input_size, int* output)
+void decompress_128_unrolled(__m128i* input, size_t input_size, size_t compression, int* output)
 {
-    size_t compression = BITS_NEEDED;
 
     __m128i source = _mm_loadu_si128(input);
 
@@ -318,6 +319,67 @@ void decompress_128_unrolled(__m128i* input, size_t input_size, int* output)
     }
 }
 
+// narrow output: unpacks into 32 bit lanes like decompress_128_unrolled and packs them before the store
+inline __m128i __unpack_128_step(uint8_t* input, size_t output_index, size_t compression, __m128i const* shuffle_mask, __m128i const* shift_mask)
+{
+    size_t mask_index = output_index % 8 != 0;
+    __m128i source = _mm_loadu_si128((__m128i*)&input[output_index * compression / 8]);
+    __m128i b = _mm_shuffle_epi8(source, shuffle_mask[mask_index]);
+    __m128i c = _mm_mullo_epi32(b, shift_mask[mask_index]);
+    return _mm_srli_epi32(c, 32 - compression);
+}
+
+// compression 1-16, writes 8 elements per iteration
+void decompress_128_16bit(__m128i* input, size_t input_size, size_t compression, uint16_t* output)
+{
+    uint8_t* in = (uint8_t*)input;
+
+    __m128i shuffle_mask[2];
+    generate_shuffle_mask_128(compression, shuffle_mask);
+
+    __m128i shift_mask[2];
+    generate_shift_masks_128(compression, shift_mask);
+
+    for (size_t output_index = 0; output_index < input_size; output_index += 8)
+    {
+        __m128i d1 = __unpack_128_step(in, output_index, compression, shuffle_mask, shift_mask);
+        __m128i d2 = __unpack_128_step(in, output_index + 4, compression, shuffle_mask, shift_mask);
+
+        _mm_storeu_si128((__m128i*)&output[output_index], _mm_packus_epi32(d1, d2));
+    }
+}
+
+// for elements that don't fit the 4 byte shuffle window (compression up to 32)
+void decompress_128_wide(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    __m128i source = _mm_loadu_si128(input);
+
+    size_t output_index = 0; // current write index of the output array
+
+    __m128i shuffle_mask_low[2], shuffle_mask_high[2];
+    generate_wide_shuffle_masks_128(compression, shuffle_mask_low, shuffle_mask_high);
+
+    __m128i shift_mask[2];
+    generate_wide_shift_masks_128(compression, shift_mask);
+
+    __m128i and_mask = _mm_set1_epi32(code_mask(compression));
+
+    while (output_index < input_size)
+    {
+        size_t mask_index = output_index % 8 != 0;
+
+        __m128i d = unpack_wide_128(source, shuffle_mask_low[mask_index], shuffle_mask_high[mask_index], shift_mask[mask_index], and_mask);
+
+        _mm_storeu_si128((__m128i*)&output[output_index], d);
+
+        output_index += 4;
+
+        // load next
+        size_t total_processed_bytes = output_index * compression / 8;
+        source = _mm_loadu_si128((__m128i*)&((uint8_t*)input)[total_processed_bytes]);
+    }
+}
+
 inline __m128i _mm_alignr_epi8_nonconst(__m128i a, __m128i b, int count)
 {
     switch (count)
@@ -343,9 +405,8 @@ inline __m128i _mm_alignr_epi8_nonconst(__m128i a, __m128i b, int count)
     return a;
 }
 
-void decompress_128_aligned(__m128i* input, size_t input_size, int* output)
+void decompress_128_aligned(__m128i* input, size_t input_size, size_t compression, int* output)
 {
-    size_t compression = BITS_NEEDED;
     size_t free_bits = 32 - compression; // most significant bits in result values that must be 0
 
     size_t mi = 0;
@@ -387,86 +448,3 @@ void decompress_128_aligned(__m128i* input, size_t input_size, int* output)
         source = _mm_alignr_epi8_nonconst(next, current, total_processed_bytes % 16);
     }
 }
-
-#ifdef __AVX__
-void decompress_256(__m128i* input, size_t input_size, int* output)
-{
-    size_t compression = BITS_NEEDED;
-
-    //avxi_t source = _mm256_loadu_si256(input);
-    __m256i source = _mm256_loadu2_m128i(input, input);
-
-    size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
-
-    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
-    
-    __m256i shift_mask = generate_shift_mask_256(compression);
-
-    while (output_index < input_size)
-    {
-        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
-
-        __m256i c = _mm256_mullo_epi32(b, shift_mask);
-
-        // shift right by fixed amount
-        __m256i d = _mm256_srli_epi32(c, 32 - compression);
-
-        _mm256_storeu_si256((__m256i*)&output[output_index], d);
-
-        output_index += 8;
-
-        // load next
-        size_t total_processed_bytes = output_index * compression / 8;
-        __m128i* next = (__m128i*)&((uint8_t*)input)[total_processed_bytes];
-        source = _mm256_loadu2_m128i(next, next);
-    }
-}
-#endif
-
-#ifdef __AVX2__
-void decompress_256_avx2(__m128i* input, size_t input_size, int* output)
-{
-    size_t compression = BITS_NEEDED;
-
-    __m256i source = _mm256_loadu2_m128i(input, input);
-
-    size_t output_index = 0; // current write index of the output array
-
-    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
-
-    // shift mask
-    size_t padding[8];
-    for (size_t i = 0; i < 8; i++)
-    {
-        padding[i] = (compression * i) % 8;
-    }
-
-    __m256i shift_mask = _mm256_setr_epi32(
-        padding[0], padding[1], padding[2], padding[3], 
-        padding[4], padding[5], padding[6], padding[7]);
-
-    // and masking (is needed here since we only do one shift!)	
-    uint32_t mask = (1 << compression) - 1;
-    __m256i and_mask = _mm256_set1_epi32(mask);
-
-    while (output_index < input_size)
-    {
-        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
-
-        // shift right by variable amount (according to static shift mask)
-        __m256i c = _mm256_srlv_epi32(b, shift_mask);
-
-        __m256i d = _mm256_and_si256(c, and_mask);
-
-        _mm256_storeu_si256((__m256i*)&output[output_index], d);
-
-        output_index += 8;
-
-        // load next
-        size_t total_processed_bytes = output_index * compression / 8;
-        __m128i* next = (__m128i*)&((uint8_t*)input)[total_processed_bytes];
-        source = _mm256_loadu2_m128i(next, next);
-    }
-}
-#endif
-
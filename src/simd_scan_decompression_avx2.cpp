@@ -0,0 +1,152 @@
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+#include "profiling.hpp"
+
+void decompress_256(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    //avxi_t source = _mm256_loadu_si256(input);
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    size_t output_index = 0; // current write index of the output array (equals # of decompressed values)
+
+    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
+    
+    __m256i shift_mask = generate_shift_mask_256(compression);
+
+    while (output_index < input_size)
+    {
+        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+
+        __m256i c = _mm256_mullo_epi32(b, shift_mask);
+
+        // shift right by fixed amount
+        __m256i d = _mm256_srli_epi32(c, 32 - compression);
+
+        _mm256_storeu_si256((__m256i*)&output[output_index], d);
+
+        output_index += 8;
+
+        // load next
+        size_t total_processed_bytes = output_index * compression / 8;
+        source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+    }
+}
+
+void decompress_256_wide(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    size_t output_index = 0; // current write index of the output array
+
+    __m128i shuffle_mask_low[2], shuffle_mask_high[2];
+    generate_wide_shuffle_masks_128(compression, shuffle_mask_low, shuffle_mask_high);
+
+    __m128i shift_mask[2];
+    generate_wide_shift_masks_128(compression, shift_mask);
+
+    // lower lane holds elements 0-3, upper lane elements 4-7
+    __m256i shuffle_mask_low_256 = _mm256_set_m128i(shuffle_mask_low[1], shuffle_mask_low[0]);
+    __m256i shuffle_mask_high_256 = _mm256_set_m128i(shuffle_mask_high[1], shuffle_mask_high[0]);
+    __m256i shift_mask_256 = _mm256_set_m128i(shift_mask[1], shift_mask[0]);
+    __m256i and_mask = _mm256_set1_epi32(code_mask(compression));
+
+    while (output_index < input_size)
+    {
+        __m256i d = unpack_wide_256(source, shuffle_mask_low_256, shuffle_mask_high_256, shift_mask_256, and_mask);
+
+        _mm256_storeu_si256((__m256i*)&output[output_index], d);
+
+        output_index += 8;
+
+        // load next
+        size_t total_processed_bytes = output_index * compression / 8;
+        source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+    }
+}
+
+void decompress_256_avx2(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    size_t output_index = 0; // current write index of the output array
+
+    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
+
+    // shift mask
+    size_t padding[8];
+    for (size_t i = 0; i < 8; i++)
+    {
+        padding[i] = (compression * i) % 8;
+    }
+
+    __m256i shift_mask = _mm256_setr_epi32(
+        padding[0], padding[1], padding[2], padding[3], 
+        padding[4], padding[5], padding[6], padding[7]);
+
+    // and masking (is needed here since we only do one shift!)	
+    uint32_t mask = code_mask(compression);
+    __m256i and_mask = _mm256_set1_epi32(mask);
+
+    while (output_index < input_size)
+    {
+        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+
+        // shift right by variable amount (according to static shift mask)
+        __m256i c = _mm256_srlv_epi32(b, shift_mask);
+
+        __m256i d = _mm256_and_si256(c, and_mask);
+
+        _mm256_storeu_si256((__m256i*)&output[output_index], d);
+
+        output_index += 8;
+
+        // load next
+        size_t total_processed_bytes = output_index * compression / 8;
+        source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+    }
+}
+
+// 16 elements per iteration from full 32 byte loads
+void decompress_256_permute(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    const uint8_t* next = (uint8_t*)input;
+    PermuteMasks256 masks(compression);
+
+    // 16 elements span exactly 2 * compression bytes
+    for (size_t output_index = 0; output_index < input_size; output_index += 16, next += 2 * compression)
+    {
+        _mm256_storeu_si256((__m256i*)&output[output_index], unpack_permute_256(next, masks, 0));
+        _mm256_storeu_si256((__m256i*)&output[output_index + 8], unpack_permute_256(next, masks, 1));
+    }
+}
+
+// narrow output versions of decompress_256_avx2
+inline __m256i __unpack_256_avx2_step(uint8_t* input, size_t output_index, size_t compression, __m256i shuffle_mask, __m256i shift_mask, __m256i and_mask)
+{
+    __m256i source = load_256_halves(&input[output_index * compression / 8], compression);
+    __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+    __m256i c = _mm256_srlv_epi32(b, shift_mask);
+    return _mm256_and_si256(c, and_mask);
+}
+
+// compression 1-16, writes 16 elements per iteration
+void decompress_256_16bit(__m128i* input, size_t input_size, size_t compression, uint16_t* output)
+{
+    uint8_t* in = (uint8_t*)input;
+
+    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
+    __m256i shift_mask = _mm256_setr_epi32(0, compression % 8, (2 * compression) % 8, (3 * compression) % 8,
+        (4 * compression) % 8, (5 * compression) % 8, (6 * compression) % 8, (7 * compression) % 8);
+    __m256i and_mask = _mm256_set1_epi32(code_mask(compression));
+
+    for (size_t output_index = 0; output_index < input_size; output_index += 16)
+    {
+        __m256i d1 = __unpack_256_avx2_step(in, output_index, compression, shuffle_mask, shift_mask, and_mask);
+        __m256i d2 = __unpack_256_avx2_step(in, output_index + 8, compression, shuffle_mask, shift_mask, and_mask);
+
+        // packus works within 128 bit lanes: [d1 0-3, d2 0-3 | d1 4-7, d2 4-7]
+        __m256i e = _mm256_permute4x64_epi64(_mm256_packus_epi32(d1, d2), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)&output[output_index], e);
+    }
+}
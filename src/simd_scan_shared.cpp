@@ -6,35 +6,34 @@
 #include "simd_scan_commons.hpp"
 #include "util.hpp"
 
-void shared_scan_128_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+void shared_scan_128_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
 {
     for (size_t i = 0; i < predicate_keys.size(); i++)
     {
-        scan_128(predicate_keys[i], input, input_size, outputs[i]);
+        scan_128(predicate_keys[i], input, input_size, compression, outputs[i]);
     }
 }
 
-void shared_scan_128_sequential_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+void shared_scan_128_sequential_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
 {
     for (size_t i = 0; i < predicate_keys.size(); i++)
     {
-        scan_128_unrolled(predicate_keys[i], input, input_size, outputs[i]);
+        scan_128_unrolled(predicate_keys[i], input, input_size, compression, outputs[i]);
     }
 }
 
-void shared_scan_128_threaded(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+void shared_scan_128_threaded(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
 {
     #pragma omp parallel for
     for (int i = 0; i < predicate_keys.size(); i++)
     {
-        scan_128(predicate_keys[i], input, input_size, outputs[i]);
+        scan_128(predicate_keys[i], input, input_size, compression, outputs[i]);
     }
 }
 
-void shared_scan_128_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+void shared_scan_128_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
 {
     size_t predicate_key_count = predicate_keys.size();
-    size_t compression = BITS_NEEDED;
 
     __m128i source = _mm_loadu_si128(input);
 
@@ -108,10 +107,9 @@ inline void __shared_scan_128_step(std::unique_ptr<uint32_t[]>& output, size_t c
     source = _mm_loadu_si128((__m128i*)&((uint8_t*)input)[total_processed_bytes]);
 }
 
-void shared_scan_128_standard_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+void shared_scan_128_standard_unrolled(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
 {
     size_t predicate_key_count = predicate_keys.size();
-    size_t compression = BITS_NEEDED;
 
     __m128i source = _mm_loadu_si128(input);
 
@@ -151,15 +149,14 @@ void shared_scan_128_standard_unrolled(std::vector<int> const& predicate_keys, _
 }
 
 // based on scan_unvectorized, just 4 times in parallel with SSE!
-void shared_scan_128_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+void shared_scan_128_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
 {
     size_t predicate_key_count = predicate_keys.size();
     uint32_t* in = reinterpret_cast<uint32_t*>(input);
-    auto compression = BITS_NEEDED;
     auto mem_size = compression * input_size;
     size_t array_size = ceil((double)mem_size / (8 * sizeof(uint32_t)));
 
-    __m128i mask = _mm_set1_epi32((1 << compression) - 1);
+    __m128i mask = _mm_set1_epi32(code_mask(compression));
 
     // process in groups of (maximum) 4 predicates
     for (size_t key_id = 0; key_id < predicate_key_count; key_id += 4)
@@ -259,7 +256,6 @@ void shared_scan_128_parallel(std::vector<int> const& predicate_keys, __m128i* i
                     out_bits_used = 0;
                 }
 
-
                 overflow_bits = compression - unread_bits;
             }
             else
@@ -282,187 +278,3 @@ void shared_scan_128_parallel(std::vector<int> const& predicate_keys, __m128i* i
         nextBatch:;
     }
 }
-
-#ifdef __AVX__
-void shared_scan_256_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
-{
-    for (size_t i = 0; i < predicate_keys.size(); i++)
-    {
-        scan_256(predicate_keys[i], input, input_size, outputs[i]);
-    }
-}
-
-void shared_scan_256_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
-{
-    size_t predicate_key_count = predicate_keys.size();
-    size_t compression = BITS_NEEDED;
-
-    //avxi_t source = _mm256_loadu_si256(input);
-    __m256i source = _mm256_loadu2_m128i(input, input);
-
-    size_t output_index = 0; // current write index of the output array
-
-    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
-
-    __m256i shift_mask = generate_shift_mask_256(compression);
-
-    while (8 * output_index < input_size)
-    {
-        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
-        __m256i c = _mm256_mullo_epi32(b, shift_mask);
-        __m256i d = _mm256_srli_epi32(c, 32 - compression);
-
-        for (size_t key_id = 0; key_id < predicate_key_count; key_id++)
-        {
-            __m256i predicate = _mm256_set1_epi32(predicate_keys[key_id]);
-            __m256i e = _mm256_cmpeq_epi32(d, predicate);
-
-            int matches = _mm256_movemask_ps(_mm256_castsi256_ps(e));
-            outputs[key_id][output_index] = matches;
-        }
-
-        // load next
-        output_index += 1;
-        size_t total_processed_bytes = (8 * output_index) * compression / 8;
-        __m128i* next = (__m128i*)&((uint8_t*)input)[total_processed_bytes];
-        source = _mm256_loadu2_m128i(next, next);
-    }
-}
-
-// based on scan_unvectorized, just 8 times in parallel with AVX!
-void shared_scan_256_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
-{
-    size_t predicate_key_count = predicate_keys.size();
-    uint32_t* in = reinterpret_cast<uint32_t*>(input);
-    auto compression = BITS_NEEDED;
-    auto mem_size = compression * input_size;
-    size_t array_size = ceil((double)mem_size / (8 * sizeof(uint32_t)));
-
-    __m256i mask = _mm256_set1_epi32((1 << compression) - 1);
-
-    // process in groups of (maximum) 8 predicates
-    for (size_t key_id = 0; key_id < predicate_key_count; key_id += 8)
-    {
-        __m256i current = _mm256_setzero_si256();
-        size_t overflow_bits = 0;
-
-        size_t oi = 0; // number of result bits written
-
-        __m256i output = _mm256_setzero_si256(); // holds 32 output bits for each compartment
-        size_t out_bits_used = 0; // can maybe be optimized away
-        __m256i output_match_mask = _mm256_set1_epi32(1); // used for masking out one bit in the comparison result register
-
-        __m256i predicate_key = _mm256_setr_epi32(
-            predicate_keys[std::min(key_id, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 1, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 2, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 3, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 4, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 5, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 6, predicate_key_count - 1)],
-            predicate_keys[std::min(key_id + 7, predicate_key_count - 1)]);
-
-        for (size_t i = 0; i < array_size; i++)
-        {
-            __m256i raw_next = _mm256_set1_epi32(in[i]);
-            __m128i shr_amount = _mm_set_epi64x(0, overflow_bits);
-            current = _mm256_srl_epi32(raw_next, shr_amount);
-
-            size_t unread_bits = (8 * sizeof(uint32_t)) - overflow_bits;
-            while (unread_bits >= compression)
-            {
-                // decompress and match against predicate
-                __m256i decompressed_element = _mm256_and_si256(current, mask);
-                __m256i match = _mm256_cmpeq_epi32(decompressed_element, predicate_key);
-
-                // mask out one bit from the comparison result and OR it to the output registers
-                __m256i masked_match = _mm256_and_si256(match, output_match_mask);
-                output = _mm256_or_si256(output, masked_match);
-                output_match_mask = _mm256_slli_epi32(output_match_mask, 1);
-                out_bits_used += 1;
-
-                // if the output register is filled, write results to the output vector
-                if (out_bits_used == 32)
-                {
-                    uint32_t result_reg[8];
-                    _mm256_storeu_si256((__m256i*)&result_reg, output);
-
-                    for (size_t key_offset = 0; key_offset < 8 && key_id + key_offset < predicate_key_count; key_offset++)
-                    {
-                        memcpy(outputs[key_id + key_offset].data() + oi, &result_reg[key_offset], sizeof(uint32_t));
-                    }
-                    oi += 4;
-
-                    // reset these registers
-                    output = _mm256_setzero_si256();
-                    output_match_mask = _mm256_set1_epi32(1);
-                    out_bits_used = 0;
-                }
-
-
-                if (oi >= input_size)
-                {
-                    goto nextBatch;
-                }
-
-                current = _mm256_srli_epi32(current, compression);
-                unread_bits -= compression;
-            }
-
-            // handle overlapping element
-            if (unread_bits != 0)
-            {
-                __m256i next = _mm256_set1_epi32(in[i + 1]);
-                __m128i shl_amount = _mm_set_epi64x(0, unread_bits);
-                current = _mm256_or_si256(current, _mm256_sll_epi32(next, shl_amount));
-
-                __m256i decompressed_element = _mm256_and_si256(current, mask);
-                __m256i match = _mm256_cmpeq_epi32(decompressed_element, predicate_key);
-
-                // mask out one bit from the comparison result and OR it to the output registers
-                __m256i masked_match = _mm256_and_si256(match, output_match_mask);
-                output = _mm256_or_si256(output, masked_match);
-                output_match_mask = _mm256_slli_epi32(output_match_mask, 1);
-                out_bits_used += 1;
-
-                // if the output register is filled, write results to the output vector
-                if (out_bits_used == 32)
-                {
-                    uint32_t result_reg[8];
-                    _mm256_storeu_si256((__m256i*)&result_reg, output);
-
-                    for (size_t key_offset = 0; key_offset < 8 && key_id + key_offset < predicate_key_count; key_offset++)
-                    {
-                        memcpy(outputs[key_id + key_offset].data() + oi, &result_reg[key_offset], sizeof(uint32_t));
-                    }
-
-                    // reset these registers
-                    output = _mm256_setzero_si256();
-                    output_match_mask = _mm256_set1_epi32(1);
-                    out_bits_used = 0;
-                }
-
-                overflow_bits = compression - unread_bits;
-            }
-            else
-            {
-                overflow_bits = 0;
-            }
-        }
-
-        if (out_bits_used != 0)
-        {
-            uint32_t result_reg[8];
-            _mm256_storeu_si256((__m256i*)&result_reg, output);
-
-            for (size_t key_offset = 0; key_offset < 8 && key_id + key_offset < predicate_key_count; key_offset++)
-            {
-                memcpy(outputs[key_id + key_offset].data() + oi, &result_reg[key_offset], sizeof(uint32_t));
-            }
-        }
-
-    nextBatch:;
-    }
-}
-#endif
-
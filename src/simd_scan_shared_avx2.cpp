@@ -0,0 +1,210 @@
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring> // memcpy
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+void shared_scan_256_sequential(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
+{
+    for (size_t i = 0; i < predicate_keys.size(); i++)
+    {
+        scan_256(predicate_keys[i], input, input_size, compression, outputs[i]);
+    }
+}
+
+void shared_scan_256_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
+{
+    size_t predicate_key_count = predicate_keys.size();
+
+    //avxi_t source = _mm256_loadu_si256(input);
+    __m256i source = load_256_halves((uint8_t*)input, compression);
+
+    size_t output_index = 0; // current write index of the output array
+
+    __m256i shuffle_mask = generate_shuffle_mask_256(compression);
+
+    __m256i shift_mask = generate_shift_mask_256(compression);
+
+    while (8 * output_index < input_size)
+    {
+        __m256i b = _mm256_shuffle_epi8(source, shuffle_mask);
+        __m256i c = _mm256_mullo_epi32(b, shift_mask);
+        __m256i d = _mm256_srli_epi32(c, 32 - compression);
+
+        for (size_t key_id = 0; key_id < predicate_key_count; key_id++)
+        {
+            __m256i predicate = _mm256_set1_epi32(predicate_keys[key_id]);
+            __m256i e = _mm256_cmpeq_epi32(d, predicate);
+
+            int matches = _mm256_movemask_ps(_mm256_castsi256_ps(e));
+            outputs[key_id][output_index] = matches;
+        }
+
+        // load next
+        output_index += 1;
+        size_t total_processed_bytes = (8 * output_index) * compression / 8;
+        source = load_256_halves(&((uint8_t*)input)[total_processed_bytes], compression);
+    }
+}
+
+// based on scan_unvectorized, just 8 times in parallel with AVX!
+void shared_scan_256_parallel(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
+{
+    size_t predicate_key_count = predicate_keys.size();
+    uint32_t* in = reinterpret_cast<uint32_t*>(input);
+    auto mem_size = compression * input_size;
+    size_t array_size = ceil((double)mem_size / (8 * sizeof(uint32_t)));
+
+    __m256i mask = _mm256_set1_epi32(code_mask(compression));
+
+    // process in groups of (maximum) 8 predicates
+    for (size_t key_id = 0; key_id < predicate_key_count; key_id += 8)
+    {
+        __m256i current = _mm256_setzero_si256();
+        size_t overflow_bits = 0;
+
+        size_t oi = 0; // number of result bits written
+
+        __m256i output = _mm256_setzero_si256(); // holds 32 output bits for each compartment
+        size_t out_bits_used = 0; // can maybe be optimized away
+        __m256i output_match_mask = _mm256_set1_epi32(1); // used for masking out one bit in the comparison result register
+
+        __m256i predicate_key = _mm256_setr_epi32(
+            predicate_keys[std::min(key_id, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 1, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 2, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 3, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 4, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 5, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 6, predicate_key_count - 1)],
+            predicate_keys[std::min(key_id + 7, predicate_key_count - 1)]);
+
+        for (size_t i = 0; i < array_size; i++)
+        {
+            __m256i raw_next = _mm256_set1_epi32(in[i]);
+            __m128i shr_amount = _mm_set_epi64x(0, overflow_bits);
+            current = _mm256_srl_epi32(raw_next, shr_amount);
+
+            size_t unread_bits = (8 * sizeof(uint32_t)) - overflow_bits;
+            while (unread_bits >= compression)
+            {
+                // decompress and match against predicate
+                __m256i decompressed_element = _mm256_and_si256(current, mask);
+                __m256i match = _mm256_cmpeq_epi32(decompressed_element, predicate_key);
+
+                // mask out one bit from the comparison result and OR it to the output registers
+                __m256i masked_match = _mm256_and_si256(match, output_match_mask);
+                output = _mm256_or_si256(output, masked_match);
+                output_match_mask = _mm256_slli_epi32(output_match_mask, 1);
+                out_bits_used += 1;
+
+                // if the output register is filled, write results to the output vector
+                if (out_bits_used == 32)
+                {
+                    uint32_t result_reg[8];
+                    _mm256_storeu_si256((__m256i*)&result_reg, output);
+
+                    for (size_t key_offset = 0; key_offset < 8 && key_id + key_offset < predicate_key_count; key_offset++)
+                    {
+                        memcpy(outputs[key_id + key_offset].data() + oi, &result_reg[key_offset], sizeof(uint32_t));
+                    }
+                    oi += 4;
+
+                    // reset these registers
+                    output = _mm256_setzero_si256();
+                    output_match_mask = _mm256_set1_epi32(1);
+                    out_bits_used = 0;
+                }
+
+
+                if (oi >= input_size)
+                {
+                    goto nextBatch;
+                }
+
+                current = _mm256_srli_epi32(current, compression);
+                unread_bits -= compression;
+            }
+
+            // handle overlapping element
+            if (unread_bits != 0)
+            {
+                __m256i next = _mm256_set1_epi32(in[i + 1]);
+                __m128i shl_amount = _mm_set_epi64x(0, unread_bits);
+                current = _mm256_or_si256(current, _mm256_sll_epi32(next, shl_amount));
+
+                __m256i decompressed_element = _mm256_and_si256(current, mask);
+                __m256i match = _mm256_cmpeq_epi32(decompressed_element, predicate_key);
+
+                // mask out one bit from the comparison result and OR it to the output registers
+                __m256i masked_match = _mm256_and_si256(match, output_match_mask);
+                output = _mm256_or_si256(output, masked_match);
+                output_match_mask = _mm256_slli_epi32(output_match_mask, 1);
+                out_bits_used += 1;
+
+                // if the output register is filled, write results to the output vector
+                if (out_bits_used == 32)
+                {
+                    uint32_t result_reg[8];
+                    _mm256_storeu_si256((__m256i*)&result_reg, output);
+
+                    for (size_t key_offset = 0; key_offset < 8 && key_id + key_offset < predicate_key_count; key_offset++)
+                    {
+                        memcpy(outputs[key_id + key_offset].data() + oi, &result_reg[key_offset], sizeof(uint32_t));
+                    }
+
+                    // reset these registers
+                    output = _mm256_setzero_si256();
+                    output_match_mask = _mm256_set1_epi32(1);
+                    out_bits_used = 0;
+                }
+
+                overflow_bits = compression - unread_bits;
+            }
+            else
+            {
+                overflow_bits = 0;
+            }
+        }
+
+        if (out_bits_used != 0)
+        {
+            uint32_t result_reg[8];
+            _mm256_storeu_si256((__m256i*)&result_reg, output);
+
+            for (size_t key_offset = 0; key_offset < 8 && key_id + key_offset < predicate_key_count; key_offset++)
+            {
+                memcpy(outputs[key_id + key_offset].data() + oi, &result_reg[key_offset], sizeof(uint32_t));
+            }
+        }
+
+    nextBatch:;
+    }
+}
+
+// 16 elements per iteration from full 32 byte loads
+void shared_scan_256_permute(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
+{
+    size_t predicate_key_count = predicate_keys.size();
+    const uint8_t* next = (uint8_t*)input;
+    PermuteMasks256 masks(compression);
+
+    // 16 elements span exactly 2 * compression bytes
+    for (size_t i = 0; i < input_size; i += 16, next += 2 * compression)
+    {
+        __m256i d1 = unpack_permute_256(next, masks, 0);
+        __m256i d2 = unpack_permute_256(next, masks, 1);
+
+        for (size_t key_id = 0; key_id < predicate_key_count; key_id++)
+        {
+            __m256i predicate = _mm256_set1_epi32(predicate_keys[key_id]);
+            __m256i e1 = _mm256_cmpeq_epi32(d1, predicate);
+            __m256i e2 = _mm256_cmpeq_epi32(d2, predicate);
+
+            uint16_t out = _mm256_movemask_ps(_mm256_castsi256_ps(e1)) | (_mm256_movemask_ps(_mm256_castsi256_ps(e2)) << 8);
+            memcpy(&outputs[key_id][i / 8], &out, sizeof(out));
+        }
+    }
+}
@@ -6,10 +6,9 @@
 #include "simd_scan_commons.hpp"
 #include "util.hpp"
 
-void shared_scan_128_linear_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<uint8_t>& outputs)
+void shared_scan_128_linear_standard(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& outputs)
 {
     size_t predicate_key_count = predicate_keys.size();
-    size_t compression = BITS_NEEDED;
 
     __m128i source = _mm_loadu_si128(input);
 
@@ -61,21 +60,21 @@ void shared_scan_128_linear_standard(std::vector<int> const& predicate_keys, __m
     }
 }
 
-void shared_scan_128_linear_simple(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, std::vector<uint8_t>& output)
+void shared_scan_128_linear_simple(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
 {
     switch (predicate_keys.size())
     {
-        case 1: shared_scan_128_linear_static<1>(predicate_keys, input, input_size, output); break;
-        case 2: shared_scan_128_linear_static<2>(predicate_keys, input, input_size, output); break;
-        case 4: shared_scan_128_linear_static<4>(predicate_keys, input, input_size, output); break;
-        case 8: shared_scan_128_linear_static<8>(predicate_keys, input, input_size, output); break;
-        case 16: shared_scan_128_linear_static<16>(predicate_keys, input, input_size, output); break;
-        case 32: shared_scan_128_linear_static<32>(predicate_keys, input, input_size, output); break;
-        case 64: shared_scan_128_linear_static<64>(predicate_keys, input, input_size, output); break;
-        case 128: shared_scan_128_linear_static<128>(predicate_keys, input, input_size, output); break;
-        case 256: shared_scan_128_linear_static<256>(predicate_keys, input, input_size, output); break;
-        case 512: shared_scan_128_linear_static<512>(predicate_keys, input, input_size, output); break;
-        case 1024: shared_scan_128_linear_static<1024>(predicate_keys, input, input_size, output); break;
+        case 1: shared_scan_128_linear_static<1>(predicate_keys, input, input_size, compression, output); break;
+        case 2: shared_scan_128_linear_static<2>(predicate_keys, input, input_size, compression, output); break;
+        case 4: shared_scan_128_linear_static<4>(predicate_keys, input, input_size, compression, output); break;
+        case 8: shared_scan_128_linear_static<8>(predicate_keys, input, input_size, compression, output); break;
+        case 16: shared_scan_128_linear_static<16>(predicate_keys, input, input_size, compression, output); break;
+        case 32: shared_scan_128_linear_static<32>(predicate_keys, input, input_size, compression, output); break;
+        case 64: shared_scan_128_linear_static<64>(predicate_keys, input, input_size, compression, output); break;
+        case 128: shared_scan_128_linear_static<128>(predicate_keys, input, input_size, compression, output); break;
+        case 256: shared_scan_128_linear_static<256>(predicate_keys, input, input_size, compression, output); break;
+        case 512: shared_scan_128_linear_static<512>(predicate_keys, input, input_size, compression, output); break;
+        case 1024: shared_scan_128_linear_static<1024>(predicate_keys, input, input_size, compression, output); break;
         default:
             std::cerr << "not supported for " << predicate_keys.size() << " predicate keys!" << std::endl;
     }
@@ -0,0 +1,187 @@
+#include <array>
+#include <utility>
+#include <algorithm>
+
+#include "simd_scan.hpp"
+#include "simd_scan_specialized.hpp"
+#include "simd_scan_aligned_width.hpp"
+#include "util.hpp"
+
+/*
+* Dispatch tables indexed by bit width, aligned widths use the kernels of simd_scan_aligned_width.hpp
+* (except for the range scan and the frame of reference/delta decompression)
+*/
+
+typedef void (*decompress_function)(const uint8_t*, size_t, int*);
+typedef int (*scan_function)(uint32_t, const uint8_t*, size_t, uint8_t*);
+typedef void (*decompress_for_function)(const uint8_t*, size_t, int64_t, int64_t*);
+typedef void (*decompress_delta_function)(const uint8_t*, size_t, size_t, int64_t, int64_t*);
+typedef int (*scan_range_function)(uint32_t, uint32_t, const uint8_t*, size_t, uint8_t*);
+typedef void (*shared_scan_function)(std::vector<int> const&, const uint8_t*, size_t, std::vector<std::vector<uint8_t>>&);
+
+template <unsigned BITS>
+constexpr decompress_function __decompress_kernel()
+{
+    if constexpr (is_aligned_width(BITS)) return &decompress_aligned_width<BITS>;
+    else return &decompress_128_static<BITS>;
+}
+
+template <unsigned BITS>
+constexpr scan_function __scan_kernel()
+{
+    if constexpr (is_aligned_width(BITS)) return &scan_aligned_width<BITS>;
+    else return &scan_128_static<BITS>;
+}
+
+template <unsigned BITS>
+constexpr shared_scan_function __shared_scan_kernel()
+{
+    if constexpr (is_aligned_width(BITS)) return &shared_scan_aligned_width<BITS>;
+    else return &shared_scan_128_static<BITS>;
+}
+
+template <size_t... I>
+constexpr std::array<decompress_function, sizeof...(I) + 1> __make_decompress_table(std::index_sequence<I...>)
+{
+    return { nullptr, __decompress_kernel<I + 1>()... };
+}
+
+template <size_t... I>
+constexpr std::array<scan_function, sizeof...(I) + 1> __make_scan_table(std::index_sequence<I...>)
+{
+    return { nullptr, __scan_kernel<I + 1>()... };
+}
+
+template <size_t... I>
+constexpr std::array<decompress_for_function, sizeof...(I) + 1> __make_decompress_for_table(std::index_sequence<I...>)
+{
+    return { nullptr, &decompress_for_128_static<I + 1>... };
+}
+
+template <size_t... I>
+constexpr std::array<decompress_delta_function, sizeof...(I) + 1> __make_decompress_delta_table(std::index_sequence<I...>)
+{
+    return { nullptr, &decompress_delta_128_static<I + 1>... };
+}
+
+template <size_t... I>
+constexpr std::array<scan_range_function, sizeof...(I) + 1> __make_scan_range_table(std::index_sequence<I...>)
+{
+    return { nullptr, &scan_range_128_static<I + 1>... };
+}
+
+template <size_t... I>
+constexpr std::array<shared_scan_function, sizeof...(I) + 1> __make_shared_scan_table(std::index_sequence<I...>)
+{
+    return { nullptr, __shared_scan_kernel<I + 1>()... };
+}
+
+static constexpr auto decompress_table = __make_decompress_table(std::make_index_sequence<32>());
+static constexpr auto scan_table = __make_scan_table(std::make_index_sequence<32>());
+static constexpr auto decompress_for_table = __make_decompress_for_table(std::make_index_sequence<32>());
+static constexpr auto decompress_delta_table = __make_decompress_delta_table(std::make_index_sequence<32>());
+static constexpr auto scan_range_table = __make_scan_range_table(std::make_index_sequence<32>());
+static constexpr auto shared_scan_table = __make_shared_scan_table(std::make_index_sequence<32>());
+
+/*
+* On cpus with AVX2 the widths that fit the shuffle window (except aligned ones) use the *_256_permute
+* kernels for all complete iterations, the remaining elements are handled by the scalar tail.
+*/
+
+static const bool use_avx2 = ENABLE_AVX2 && cpu_supports_avx2();
+
+static bool use_avx2_kernels(size_t compression)
+{
+    return use_avx2 && fits_shuffle_window(compression) && !is_aligned_width(compression);
+}
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void decompress(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    if (!check_compression(compression)) return;
+
+#if ENABLE_AVX2
+    if (use_avx2_kernels(compression))
+    {
+        size_t vectorized_size = input_size - input_size % 16;
+        decompress_256_permute(input, vectorized_size, compression, output);
+        decompress_tail((uint8_t*)input, vectorized_size, input_size, compression, output);
+        return;
+    }
+#endif
+
+    decompress_table[compression]((uint8_t*)input, input_size, output);
+}
+
+int scan(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // keys that can't be represented with the given compression never match
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+#if ENABLE_AVX2
+    if (use_avx2_kernels(compression))
+    {
+        size_t vectorized_size = input_size - input_size % 32;
+        int hits = scan_256_permute(predicate_key, input, vectorized_size, compression, output);
+        return hits + scan_tail(predicate_key, (uint8_t*)input, vectorized_size, input_size, compression, output.data());
+    }
+#endif
+
+    return scan_table[compression](predicate_key, (uint8_t*)input, input_size, output.data());
+}
+
+void shared_scan(std::vector<int> const& predicate_keys, __m128i* input, size_t input_size, size_t compression, std::vector<std::vector<uint8_t>>& outputs)
+{
+    if (!check_compression(compression)) return;
+
+#if ENABLE_AVX2
+    if (use_avx2_kernels(compression))
+    {
+        size_t vectorized_size = input_size - input_size % 16;
+        shared_scan_256_permute(predicate_keys, input, vectorized_size, compression, outputs);
+        for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+        {
+            scan_tail(predicate_keys[key_id], (uint8_t*)input, vectorized_size, input_size, compression, outputs[key_id].data());
+        }
+        return;
+    }
+#endif
+
+    shared_scan_table[compression](predicate_keys, (uint8_t*)input, input_size, outputs);
+}
+
+int scan_range(uint32_t predicate_low, uint32_t predicate_high, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    return scan_range_table[compression](predicate_low, predicate_high, (uint8_t*)input, input_size, output.data());
+}
+
+void decompress_for(__m128i* input, size_t input_size, size_t compression, int64_t base, int64_t* output)
+{
+    if (!check_compression(compression)) return;
+
+    decompress_for_table[compression]((uint8_t*)input, input_size, base, output);
+}
+
+void decompress_delta(__m128i* input, size_t begin, size_t end, size_t compression, int64_t start, int64_t* output)
+{
+    if (!check_compression(compression)) return;
+
+    decompress_delta_table[compression]((uint8_t*)input, begin, end, start, output);
+}
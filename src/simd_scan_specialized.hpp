@@ -0,0 +1,442 @@
+#pragma once
+
+#include <immintrin.h>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* Kernels specialized for a fixed bit width.
+*
+* A block of 32 elements always spans 4 * BITS bytes, so the byte offsets and masks of its 8 steps
+* (4 elements each) are known at compile time. The mask schedule of every width repeats after at
+* most 8 elements, therefore one block covers a whole number of periods and can be fully unrolled
+* with independent loads.
+*
+* Widths whose elements don't fit the 4 byte shuffle window are assembled from two shuffles instead
+* (see generate_wide_shuffle_masks_128). The last element of a step ends within the 16 byte window
+* for every width up to 32, so the same step layout is used for them.
+*/
+
+template <unsigned BITS>
+struct StaticMasks128
+{
+    static_assert(BITS >= 1 && BITS <= 32, "unsupported bit width");
+
+    static constexpr size_t block_size = 32; // elements per unrolled block
+    static constexpr size_t block_bytes = 4 * BITS; // bytes per unrolled block
+    static constexpr bool wide = !fits_shuffle_window(BITS);
+
+    alignas(16) uint8_t shuffle[8][16];
+    alignas(16) uint32_t shift[8][4]; // multipliers for the variable left shift
+    alignas(16) uint32_t clean[8][4]; // element masks at their bit padding
+    alignas(16) uint32_t padding_mult[8][4]; // moves a predicate to the bit padding of the element
+    size_t offset[8]; // byte offset of each step within the block
+
+    // wide widths only
+    alignas(16) uint8_t shuffle_low[8][16];
+    alignas(16) uint8_t shuffle_high[8][16];
+    alignas(16) uint32_t wide_shift[8][4];
+
+    static constexpr StaticMasks128 generate()
+    {
+        StaticMasks128 masks{};
+
+        for (size_t step = 0; step < 8; step++)
+        {
+            masks.offset[step] = (4 * step * BITS) / 8;
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                size_t bit_index = (4 * step + i) * BITS;
+                size_t input_offset = bit_index / 8 - masks.offset[step];
+                size_t padding = bit_index % 8;
+
+                for (size_t j = 0; j < 4; j++)
+                {
+                    masks.shuffle[step][4 * i + j] = input_offset + j < 16 ? input_offset + j : 0x80;
+                }
+
+                masks.shift[step][i] = BITS + padding <= 32 ? uint32_t(1) << (32 - BITS - padding) : 0;
+                masks.clean[step][i] = code_mask(BITS) << padding;
+
+                // wide elements are compared after they have been moved to bit 0
+                masks.padding_mult[step][i] = wide ? 1 : uint32_t(1) << padding;
+
+                masks.shuffle_low[step][4 * i] = input_offset;
+                for (size_t j = 1; j < 4; j++)
+                {
+                    masks.shuffle_low[step][4 * i + j] = 0x80;
+                }
+                for (size_t j = 0; j < 4; j++)
+                {
+                    masks.shuffle_high[step][4 * i + j] = input_offset + 1 + j < 16 ? input_offset + 1 + j : 0x80;
+                }
+                masks.wide_shift[step][i] = uint32_t(1) << (8 - padding);
+            }
+        }
+
+        return masks;
+    }
+};
+
+template <unsigned BITS>
+constexpr StaticMasks128<BITS> static_masks_128 = StaticMasks128<BITS>::generate();
+
+/*
+* Scalar handling of the elements that don't fill a whole block (begin must be a multiple of 8),
+* done by the BMI2 kernels if the cpu supports them.
+*/
+
+inline void decompress_tail(const uint8_t* input, size_t begin, size_t end, size_t compression, int* output)
+{
+#if ENABLE_BMI2
+    if (cpu_supports_bmi2())
+    {
+        decompress_tail_bmi2(input, begin, end, compression, output);
+        return;
+    }
+#endif
+
+    for (size_t i = begin; i < end; i++)
+    {
+        output[i] = extract_element(input, i, compression);
+    }
+}
+
+inline int scan_tail(uint32_t predicate_key, const uint8_t* input, size_t begin, size_t end, size_t compression, uint8_t* output)
+{
+#if ENABLE_BMI2
+    if (cpu_supports_bmi2())
+    {
+        return scan_tail_bmi2(predicate_key, input, begin, end, compression, output);
+    }
+#endif
+
+    int hits = 0;
+
+    for (size_t i = begin; i < end; i += 8)
+    {
+        uint8_t out = 0;
+        for (size_t j = 0; j < 8 && i + j < end; j++)
+        {
+            out |= (extract_element(input, i + j, compression) == predicate_key) << j;
+        }
+
+        output[i / 8] = out;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+inline int scan_range_tail(uint32_t predicate_low, uint32_t predicate_high, const uint8_t* input, size_t begin, size_t end, size_t compression, uint8_t* output)
+{
+    int hits = 0;
+
+    for (size_t i = begin; i < end; i += 8)
+    {
+        uint8_t out = 0;
+        for (size_t j = 0; j < 8 && i + j < end; j++)
+        {
+            uint64_t element = extract_element(input, i + j, compression);
+            out |= (predicate_low <= element && element <= predicate_high) << j;
+        }
+
+        output[i / 8] = out;
+        hits += POPCNT(out);
+    }
+
+    return hits;
+}
+
+/*
+* SIMD kernels (SSE4.1; 128bit)
+*/
+
+template <unsigned BITS, size_t STEP>
+inline __m128i __unpack_128_static_step(const uint8_t* block)
+{
+    constexpr auto const& masks = static_masks_128<BITS>;
+
+    __m128i source = _mm_loadu_si128((__m128i const*)&block[masks.offset[STEP]]);
+
+    if constexpr (StaticMasks128<BITS>::wide)
+    {
+        return unpack_wide_128(source,
+            _mm_load_si128((__m128i const*)masks.shuffle_low[STEP]),
+            _mm_load_si128((__m128i const*)masks.shuffle_high[STEP]),
+            _mm_load_si128((__m128i const*)masks.wide_shift[STEP]),
+            _mm_set1_epi32(code_mask(BITS)));
+    }
+    else
+    {
+        __m128i b = _mm_shuffle_epi8(source, _mm_load_si128((__m128i const*)masks.shuffle[STEP]));
+        __m128i c = _mm_mullo_epi32(b, _mm_load_si128((__m128i const*)masks.shift[STEP]));
+        return _mm_srli_epi32(c, 32 - BITS);
+    }
+}
+
+template <unsigned BITS, size_t STEP>
+inline uint32_t __scan_128_static_step(const uint8_t* block, __m128i const* predicate)
+{
+    constexpr auto const& masks = static_masks_128<BITS>;
+
+    __m128i c;
+    if constexpr (StaticMasks128<BITS>::wide)
+    {
+        c = __unpack_128_static_step<BITS, STEP>(block);
+    }
+    else
+    {
+        // no shifts needed, compare at the bit padding of the elements
+        __m128i source = _mm_loadu_si128((__m128i const*)&block[masks.offset[STEP]]);
+        __m128i b = _mm_shuffle_epi8(source, _mm_load_si128((__m128i const*)masks.shuffle[STEP]));
+        c = _mm_and_si128(b, _mm_load_si128((__m128i const*)masks.clean[STEP]));
+    }
+
+    __m128i e = _mm_cmpeq_epi32(c, predicate[STEP]);
+    return uint32_t(_mm_movemask_ps(_mm_castsi128_ps(e))) << (4 * STEP);
+}
+
+template <unsigned BITS>
+void decompress_128_static(const uint8_t* input, size_t input_size, int* output)
+{
+    using Masks = StaticMasks128<BITS>;
+
+    size_t block_count = input_size / Masks::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Masks::block_bytes];
+        int* out = &output[block_index * Masks::block_size];
+
+        _mm_storeu_si128((__m128i*)&out[0], __unpack_128_static_step<BITS, 0>(block));
+        _mm_storeu_si128((__m128i*)&out[4], __unpack_128_static_step<BITS, 1>(block));
+        _mm_storeu_si128((__m128i*)&out[8], __unpack_128_static_step<BITS, 2>(block));
+        _mm_storeu_si128((__m128i*)&out[12], __unpack_128_static_step<BITS, 3>(block));
+        _mm_storeu_si128((__m128i*)&out[16], __unpack_128_static_step<BITS, 4>(block));
+        _mm_storeu_si128((__m128i*)&out[20], __unpack_128_static_step<BITS, 5>(block));
+        _mm_storeu_si128((__m128i*)&out[24], __unpack_128_static_step<BITS, 6>(block));
+        _mm_storeu_si128((__m128i*)&out[28], __unpack_128_static_step<BITS, 7>(block));
+    }
+
+    decompress_tail(input, block_count * Masks::block_size, input_size, BITS, output);
+}
+
+// frame of reference: the base is added to the widened elements within the loop
+template <unsigned BITS, size_t STEP>
+inline void __decompress_for_128_static_step(const uint8_t* block, __m128i base, int64_t* output)
+{
+    __m128i d = __unpack_128_static_step<BITS, STEP>(block);
+    _mm_storeu_si128((__m128i*)&output[4 * STEP], _mm_add_epi64(_mm_cvtepu32_epi64(d), base));
+    _mm_storeu_si128((__m128i*)&output[4 * STEP + 2], _mm_add_epi64(_mm_cvtepu32_epi64(_mm_srli_si128(d, 8)), base));
+}
+
+template <unsigned BITS>
+void decompress_for_128_static(const uint8_t* input, size_t input_size, int64_t base, int64_t* output)
+{
+    using Masks = StaticMasks128<BITS>;
+
+    const __m128i base_vector = _mm_set1_epi64x(base);
+    size_t block_count = input_size / Masks::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Masks::block_bytes];
+        int64_t* out = &output[block_index * Masks::block_size];
+
+        __decompress_for_128_static_step<BITS, 0>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 1>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 2>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 3>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 4>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 5>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 6>(block, base_vector, out);
+        __decompress_for_128_static_step<BITS, 7>(block, base_vector, out);
+    }
+
+    for (size_t i = block_count * Masks::block_size; i < input_size; i++)
+    {
+        output[i] = base + (int64_t)extract_element(input, i, BITS);
+    }
+}
+
+// delta decoding: 64 bit prefix sum of the 4 elements of a step on top of the previous value
+template <unsigned BITS, size_t STEP>
+inline __m128i __decompress_delta_128_static_step(const uint8_t* block, __m128i previous, int64_t* output)
+{
+    __m128i d = __unpack_128_static_step<BITS, STEP>(block);
+
+    __m128i low = _mm_cvtepu32_epi64(d);
+    __m128i high = _mm_cvtepu32_epi64(_mm_srli_si128(d, 8));
+    low = _mm_add_epi64(_mm_add_epi64(low, _mm_slli_si128(low, 8)), previous);
+    high = _mm_add_epi64(_mm_add_epi64(high, _mm_slli_si128(high, 8)), _mm_unpackhi_epi64(low, low));
+
+    _mm_storeu_si128((__m128i*)&output[4 * STEP], low);
+    _mm_storeu_si128((__m128i*)&output[4 * STEP + 2], high);
+    return _mm_unpackhi_epi64(high, high);
+}
+
+// output[i - begin] = start + sum of the elements [begin, i], begin has to be a multiple of 32
+template <unsigned BITS>
+void decompress_delta_128_static(const uint8_t* input, size_t begin, size_t end, int64_t start, int64_t* output)
+{
+    using Masks = StaticMasks128<BITS>;
+
+    __m128i previous = _mm_set1_epi64x(start);
+    size_t block_index = begin / Masks::block_size;
+    size_t block_end = end / Masks::block_size;
+
+    for (; block_index < block_end; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Masks::block_bytes];
+        int64_t* out = &output[block_index * Masks::block_size - begin];
+
+        previous = __decompress_delta_128_static_step<BITS, 0>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 1>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 2>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 3>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 4>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 5>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 6>(block, previous, out);
+        previous = __decompress_delta_128_static_step<BITS, 7>(block, previous, out);
+    }
+
+    int64_t value = _mm_cvtsi128_si64(previous);
+    for (size_t i = std::max(begin, block_end * Masks::block_size); i < end; i++)
+    {
+        value += (int64_t)extract_element(input, i, BITS);
+        output[i - begin] = value;
+    }
+}
+
+template <unsigned BITS>
+int scan_128_static(uint32_t predicate_key, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    using Masks = StaticMasks128<BITS>;
+    constexpr auto const& masks = static_masks_128<BITS>;
+
+    // predicate moved to the bit padding of each element
+    __m128i predicate[8];
+    for (size_t step = 0; step < 8; step++)
+    {
+        predicate[step] = _mm_mullo_epi32(_mm_set1_epi32(predicate_key), _mm_load_si128((__m128i const*)masks.padding_mult[step]));
+    }
+
+    int hits = 0;
+    size_t block_count = input_size / Masks::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Masks::block_bytes];
+
+        uint32_t out = __scan_128_static_step<BITS, 0>(block, predicate)
+            | __scan_128_static_step<BITS, 1>(block, predicate)
+            | __scan_128_static_step<BITS, 2>(block, predicate)
+            | __scan_128_static_step<BITS, 3>(block, predicate)
+            | __scan_128_static_step<BITS, 4>(block, predicate)
+            | __scan_128_static_step<BITS, 5>(block, predicate)
+            | __scan_128_static_step<BITS, 6>(block, predicate)
+            | __scan_128_static_step<BITS, 7>(block, predicate);
+
+        memcpy(&output[4 * block_index], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    hits += scan_tail(predicate_key, input, block_count * Masks::block_size, input_size, BITS, output);
+    return hits;
+}
+
+template <unsigned BITS>
+int scan_range_128_static(uint32_t predicate_low, uint32_t predicate_high, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    using Masks = StaticMasks128<BITS>;
+
+    const __m128i low = _mm_set1_epi32(predicate_low);
+    const __m128i high = _mm_set1_epi32(predicate_high);
+
+    int hits = 0;
+    size_t block_count = input_size / Masks::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Masks::block_bytes];
+
+        __m128i d[8] = {
+            __unpack_128_static_step<BITS, 0>(block),
+            __unpack_128_static_step<BITS, 1>(block),
+            __unpack_128_static_step<BITS, 2>(block),
+            __unpack_128_static_step<BITS, 3>(block),
+            __unpack_128_static_step<BITS, 4>(block),
+            __unpack_128_static_step<BITS, 5>(block),
+            __unpack_128_static_step<BITS, 6>(block),
+            __unpack_128_static_step<BITS, 7>(block)
+        };
+
+        // unsigned comparisons: low <= d <= high iff max(d, low) == d and min(d, high) == d
+        uint32_t out = 0;
+        for (size_t step = 0; step < 8; step++)
+        {
+            __m128i e = _mm_and_si128(
+                _mm_cmpeq_epi32(_mm_max_epu32(d[step], low), d[step]),
+                _mm_cmpeq_epi32(_mm_min_epu32(d[step], high), d[step]));
+            out |= uint32_t(_mm_movemask_ps(_mm_castsi128_ps(e))) << (4 * step);
+        }
+
+        memcpy(&output[4 * block_index], &out, sizeof(out));
+        hits += POPCNT(out);
+    }
+
+    hits += scan_range_tail(predicate_low, predicate_high, input, block_count * Masks::block_size, input_size, BITS, output);
+    return hits;
+}
+
+template <unsigned BITS>
+void shared_scan_128_static(std::vector<int> const& predicate_keys, const uint8_t* input, size_t input_size, std::vector<std::vector<uint8_t>>& outputs)
+{
+    using Masks = StaticMasks128<BITS>;
+
+    size_t predicate_key_count = predicate_keys.size();
+    size_t block_count = input_size / Masks::block_size;
+
+    for (size_t block_index = 0; block_index < block_count; block_index++)
+    {
+        const uint8_t* block = &input[block_index * Masks::block_bytes];
+
+        // decompress the block once, then compare it against all predicates
+        __m128i d[8] = {
+            __unpack_128_static_step<BITS, 0>(block),
+            __unpack_128_static_step<BITS, 1>(block),
+            __unpack_128_static_step<BITS, 2>(block),
+            __unpack_128_static_step<BITS, 3>(block),
+            __unpack_128_static_step<BITS, 4>(block),
+            __unpack_128_static_step<BITS, 5>(block),
+            __unpack_128_static_step<BITS, 6>(block),
+            __unpack_128_static_step<BITS, 7>(block)
+        };
+
+        for (size_t key_id = 0; key_id < predicate_key_count; key_id++)
+        {
+            __m128i predicate = _mm_set1_epi32(predicate_keys[key_id]);
+
+            uint32_t out = 0;
+            for (size_t step = 0; step < 8; step++)
+            {
+                __m128i e = _mm_cmpeq_epi32(d[step], predicate);
+                out |= uint32_t(_mm_movemask_ps(_mm_castsi128_ps(e))) << (4 * step);
+            }
+
+            memcpy(&outputs[key_id][4 * block_index], &out, sizeof(out));
+        }
+    }
+
+    for (size_t key_id = 0; key_id < predicate_key_count; key_id++)
+    {
+        scan_tail(predicate_keys[key_id], input, block_count * Masks::block_size, input_size, BITS, outputs[key_id].data());
+    }
+}
@@ -0,0 +1,255 @@
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* Vertical layout, 128bit kernels
+*
+* The lanes 0-3 and 4-7 of a block are processed as two independent 4 lane streams, in each row
+* the first half yields the elements 8 * row + 0..3 and the second half 8 * row + 4..7. A lane
+* word is loaded once and shifted for all elements that start in it, so every element costs a
+* fixed shift, an and and (if it straddles two words) a shift and an or.
+*/
+
+size_t vertical_buffer_size(size_t compression, size_t input_size)
+{
+    size_t blocks = (input_size + vertical_block_size - 1) / vertical_block_size;
+    return blocks * compression * 32;
+}
+
+template <typename T>
+std::unique_ptr<uint64_t[]> compress_vertical(std::vector<T> const& input, size_t compression)
+{
+    auto buffer = std::make_unique<uint64_t[]>(vertical_buffer_size(compression, input.size()) / sizeof(uint64_t));
+    uint32_t* words = (uint32_t*)buffer.get();
+
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        size_t block = i / vertical_block_size;
+        size_t lane = i % 8;
+        size_t bit_index = (i % vertical_block_size) / 8 * compression;
+
+        uint64_t element = uint64_t(input[i]) & code_mask(compression);
+        size_t word = (block * compression + bit_index / 32) * 8 + lane;
+
+        words[word] |= (uint32_t)(element << (bit_index % 32));
+        if (bit_index % 32 + compression > 32)
+        {
+            words[word + 8] |= (uint32_t)(element >> (32 - bit_index % 32));
+        }
+    }
+
+    return buffer;
+}
+
+// element ROW of the lanes, current holds the lane word that contains its first bit
+template <unsigned BITS, unsigned ROW>
+inline __m128i __unpack_vertical_128_step(const __m128i* words, __m128i& current, __m128i mask)
+{
+    constexpr unsigned shift = (ROW * BITS) % 32;
+    constexpr unsigned word = (ROW * BITS) / 32;
+
+    __m128i element = _mm_srli_epi32(current, shift);
+
+    // the last element of a block ends with its last word
+    if constexpr (shift + BITS >= 32 && ROW + 1 < vertical_block_size / 8)
+    {
+        // consecutive lane words are 256 bits apart
+        current = _mm_load_si128(words + 2 * (word + 1));
+        if constexpr (shift + BITS > 32)
+        {
+            element = _mm_or_si128(element, _mm_slli_epi32(current, 32 - shift));
+        }
+    }
+
+    if constexpr (BITS < 32)
+    {
+        element = _mm_and_si128(element, mask);
+    }
+    return element;
+}
+
+// calls consume(row, elements 8 * row + 0..3, elements 8 * row + 4..7) for the 32 rows of a block
+template <unsigned BITS, typename Consumer, size_t... ROW>
+inline void __unpack_vertical_128_block(const __m128i* block, Consumer&& consume, std::index_sequence<ROW...>)
+{
+    const __m128i mask = _mm_set1_epi32(code_mask(BITS));
+    __m128i low = _mm_load_si128(block);
+    __m128i high = _mm_load_si128(block + 1);
+
+    (consume(ROW,
+        __unpack_vertical_128_step<BITS, ROW>(block, low, mask),
+        __unpack_vertical_128_step<BITS, ROW>(block + 1, high, mask)), ...);
+}
+
+template <unsigned BITS>
+inline void __decompress_vertical_128_block(const __m128i* block, int* output)
+{
+    __unpack_vertical_128_block<BITS>(block, [&](size_t row, __m128i low, __m128i high)
+    {
+        _mm_storeu_si128((__m128i*)(output + 8 * row), low);
+        _mm_storeu_si128((__m128i*)(output + 8 * row + 4), high);
+    }, std::make_index_sequence<vertical_block_size / 8>());
+}
+
+template <unsigned BITS>
+inline int __scan_vertical_128_block(__m128i predicate, const __m128i* block, uint8_t* output)
+{
+    int hits = 0;
+    uint64_t bitmap = 0;
+    __unpack_vertical_128_block<BITS>(block, [&](size_t row, __m128i low, __m128i high)
+    {
+        int mask_low = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, predicate)));
+        int mask_high = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, predicate)));
+        bitmap |= uint64_t(mask_low | (mask_high << 4)) << (8 * (row % 8));
+
+        // the masks of 8 rows are written at once
+        if (row % 8 == 7)
+        {
+            memcpy(output + row - 7, &bitmap, sizeof(bitmap));
+            hits += (int)POPCNT64(bitmap);
+            bitmap = 0;
+        }
+    }, std::make_index_sequence<vertical_block_size / 8>());
+    return hits;
+}
+
+template <unsigned BITS>
+static void decompress_vertical_128_static(const uint8_t* input, size_t input_size, int* output)
+{
+    const __m128i* blocks = (const __m128i*)input;
+
+    size_t full_blocks = input_size / vertical_block_size;
+    for (size_t block = 0; block < full_blocks; block++)
+    {
+        __decompress_vertical_128_block<BITS>(blocks + 2 * BITS * block, output + vertical_block_size * block);
+    }
+
+    // the last block is decompressed into a temporary buffer to not write past input_size elements
+    size_t rest = input_size % vertical_block_size;
+    if (rest > 0)
+    {
+        alignas(16) int elements[vertical_block_size];
+        __decompress_vertical_128_block<BITS>(blocks + 2 * BITS * full_blocks, elements);
+        memcpy(output + vertical_block_size * full_blocks, elements, rest * sizeof(int));
+    }
+}
+
+template <unsigned BITS>
+static int scan_vertical_128_static(uint32_t predicate_key, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    const __m128i* blocks = (const __m128i*)input;
+    const __m128i predicate = _mm_set1_epi32(predicate_key);
+
+    int hits = 0;
+    size_t full_blocks = input_size / vertical_block_size;
+    for (size_t block = 0; block < full_blocks; block++)
+    {
+        hits += __scan_vertical_128_block<BITS>(predicate, blocks + 2 * BITS * block, output + vertical_block_size / 8 * block);
+    }
+
+    // the zero padding of the last block must not match
+    size_t rest = input_size % vertical_block_size;
+    if (rest > 0)
+    {
+        uint8_t bitmap[vertical_block_size / 8];
+        __scan_vertical_128_block<BITS>(predicate, blocks + 2 * BITS * full_blocks, bitmap);
+        if (rest % 8 != 0)
+        {
+            bitmap[rest / 8] &= (1 << (rest % 8)) - 1;
+        }
+
+        uint8_t* last_output = output + vertical_block_size / 8 * full_blocks;
+        for (size_t i = 0; i < (rest + 7) / 8; i++)
+        {
+            last_output[i] = bitmap[i];
+            hits += POPCNT(bitmap[i]);
+        }
+    }
+
+    return hits;
+}
+
+typedef void (*decompress_vertical_function)(const uint8_t*, size_t, int*);
+typedef int (*scan_vertical_function)(uint32_t, const uint8_t*, size_t, uint8_t*);
+
+template <size_t... I>
+constexpr std::array<decompress_vertical_function, sizeof...(I) + 1> __make_decompress_vertical_table(std::index_sequence<I...>)
+{
+    return { nullptr, &decompress_vertical_128_static<I + 1>... };
+}
+
+template <size_t... I>
+constexpr std::array<scan_vertical_function, sizeof...(I) + 1> __make_scan_vertical_table(std::index_sequence<I...>)
+{
+    return { nullptr, &scan_vertical_128_static<I + 1>... };
+}
+
+static constexpr auto decompress_vertical_table = __make_decompress_vertical_table(std::make_index_sequence<32>());
+static constexpr auto scan_vertical_table = __make_scan_vertical_table(std::make_index_sequence<32>());
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void decompress_vertical_128(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    if (!check_compression(compression)) return;
+
+    decompress_vertical_table[compression]((uint8_t*)input, input_size, output);
+}
+
+int scan_vertical_128(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    // keys that can't be represented with the given compression never match
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    return scan_vertical_table[compression](predicate_key, (uint8_t*)input, input_size, output.data());
+}
+
+static const bool use_avx2 = ENABLE_AVX2 && cpu_supports_avx2();
+
+void decompress_vertical(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        decompress_vertical_256(input, input_size, compression, output);
+        return;
+    }
+#endif
+
+    decompress_vertical_128(input, input_size, compression, output);
+}
+
+int scan_vertical(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+#if ENABLE_AVX2
+    if (use_avx2)
+    {
+        return scan_vertical_256(predicate_key, input, input_size, compression, output);
+    }
+#endif
+
+    return scan_vertical_128(predicate_key, input, input_size, compression, output);
+}
+
+template std::unique_ptr<uint64_t[]> compress_vertical<uint16_t>(std::vector<uint16_t> const& input, size_t compression);
+template std::unique_ptr<uint64_t[]> compress_vertical<uint32_t>(std::vector<uint32_t> const& input, size_t compression);
@@ -0,0 +1,181 @@
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "util.hpp"
+
+/*
+* Vertical layout, 256bit kernels
+*
+* Same as the 128bit kernels, but all 8 lanes of a row are unpacked at once and the compare mask
+* of a row is directly one byte of the output. The buffer is only guaranteed to be 16 byte aligned,
+* hence unaligned loads.
+*/
+
+template <unsigned BITS, unsigned ROW>
+inline __m256i __unpack_vertical_256_step(const __m256i* words, __m256i& current, __m256i mask)
+{
+    constexpr unsigned shift = (ROW * BITS) % 32;
+    constexpr unsigned word = (ROW * BITS) / 32;
+
+    __m256i element = _mm256_srli_epi32(current, shift);
+
+    if constexpr (shift + BITS >= 32 && ROW + 1 < vertical_block_size / 8)
+    {
+        current = _mm256_loadu_si256(words + word + 1);
+        if constexpr (shift + BITS > 32)
+        {
+            element = _mm256_or_si256(element, _mm256_slli_epi32(current, 32 - shift));
+        }
+    }
+
+    if constexpr (BITS < 32)
+    {
+        element = _mm256_and_si256(element, mask);
+    }
+    return element;
+}
+
+// calls consume(row, elements 8 * row + 0..7) for the 32 rows of a block
+template <unsigned BITS, typename Consumer, size_t... ROW>
+inline void __unpack_vertical_256_block(const __m256i* block, Consumer&& consume, std::index_sequence<ROW...>)
+{
+    const __m256i mask = _mm256_set1_epi32(code_mask(BITS));
+    __m256i current = _mm256_loadu_si256(block);
+
+    (consume(ROW, __unpack_vertical_256_step<BITS, ROW>(block, current, mask)), ...);
+}
+
+template <unsigned BITS>
+inline void __decompress_vertical_256_block(const __m256i* block, int* output)
+{
+    __unpack_vertical_256_block<BITS>(block, [&](size_t row, __m256i elements)
+    {
+        _mm256_storeu_si256((__m256i*)(output + 8 * row), elements);
+    }, std::make_index_sequence<vertical_block_size / 8>());
+}
+
+template <unsigned BITS>
+inline int __scan_vertical_256_block(__m256i predicate, const __m256i* block, uint8_t* output)
+{
+    int hits = 0;
+    uint64_t bitmap = 0;
+    __unpack_vertical_256_block<BITS>(block, [&](size_t row, __m256i elements)
+    {
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(elements, predicate)));
+        bitmap |= uint64_t(mask) << (8 * (row % 8));
+
+        if (row % 8 == 7)
+        {
+            memcpy(output + row - 7, &bitmap, sizeof(bitmap));
+            hits += (int)POPCNT64(bitmap);
+            bitmap = 0;
+        }
+    }, std::make_index_sequence<vertical_block_size / 8>());
+    return hits;
+}
+
+template <unsigned BITS>
+static void decompress_vertical_256_static(const uint8_t* input, size_t input_size, int* output)
+{
+    const __m256i* blocks = (const __m256i*)input;
+
+    size_t full_blocks = input_size / vertical_block_size;
+    for (size_t block = 0; block < full_blocks; block++)
+    {
+        __decompress_vertical_256_block<BITS>(blocks + BITS * block, output + vertical_block_size * block);
+    }
+
+    size_t rest = input_size % vertical_block_size;
+    if (rest > 0)
+    {
+        alignas(32) int elements[vertical_block_size];
+        __decompress_vertical_256_block<BITS>(blocks + BITS * full_blocks, elements);
+        memcpy(output + vertical_block_size * full_blocks, elements, rest * sizeof(int));
+    }
+}
+
+template <unsigned BITS>
+static int scan_vertical_256_static(uint32_t predicate_key, const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    const __m256i* blocks = (const __m256i*)input;
+    const __m256i predicate = _mm256_set1_epi32(predicate_key);
+
+    int hits = 0;
+    size_t full_blocks = input_size / vertical_block_size;
+    for (size_t block = 0; block < full_blocks; block++)
+    {
+        hits += __scan_vertical_256_block<BITS>(predicate, blocks + BITS * block, output + vertical_block_size / 8 * block);
+    }
+
+    size_t rest = input_size % vertical_block_size;
+    if (rest > 0)
+    {
+        uint8_t bitmap[vertical_block_size / 8];
+        __scan_vertical_256_block<BITS>(predicate, blocks + BITS * full_blocks, bitmap);
+        if (rest % 8 != 0)
+        {
+            bitmap[rest / 8] &= (1 << (rest % 8)) - 1;
+        }
+
+        uint8_t* last_output = output + vertical_block_size / 8 * full_blocks;
+        for (size_t i = 0; i < (rest + 7) / 8; i++)
+        {
+            last_output[i] = bitmap[i];
+            hits += POPCNT(bitmap[i]);
+        }
+    }
+
+    return hits;
+}
+
+typedef void (*decompress_vertical_function)(const uint8_t*, size_t, int*);
+typedef int (*scan_vertical_function)(uint32_t, const uint8_t*, size_t, uint8_t*);
+
+template <size_t... I>
+constexpr std::array<decompress_vertical_function, sizeof...(I) + 1> __make_decompress_vertical_table(std::index_sequence<I...>)
+{
+    return { nullptr, &decompress_vertical_256_static<I + 1>... };
+}
+
+template <size_t... I>
+constexpr std::array<scan_vertical_function, sizeof...(I) + 1> __make_scan_vertical_table(std::index_sequence<I...>)
+{
+    return { nullptr, &scan_vertical_256_static<I + 1>... };
+}
+
+static constexpr auto decompress_vertical_table = __make_decompress_vertical_table(std::make_index_sequence<32>());
+static constexpr auto scan_vertical_table = __make_scan_vertical_table(std::make_index_sequence<32>());
+
+static bool check_compression(size_t compression)
+{
+    if (compression < 1 || compression > 32)
+    {
+        std::cerr << "not supported for compression " << compression << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void decompress_vertical_256(__m128i* input, size_t input_size, size_t compression, int* output)
+{
+    if (!check_compression(compression)) return;
+
+    decompress_vertical_table[compression]((uint8_t*)input, input_size, output);
+}
+
+int scan_vertical_256(int predicate_key, __m128i* input, size_t input_size, size_t compression, std::vector<uint8_t>& output)
+{
+    if (!check_compression(compression)) return 0;
+
+    if ((uint32_t)predicate_key > code_mask(compression))
+    {
+        std::fill(output.begin(), output.begin() + (input_size + 7) / 8, 0);
+        return 0;
+    }
+
+    return scan_vertical_table[compression](predicate_key, (uint8_t*)input, input_size, output.data());
+}
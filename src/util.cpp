@@ -2,9 +2,15 @@
 #include <stdint.h>
 #include <iomanip>
 #include <math.h>
+#include <algorithm>
 
 #include "util.hpp"
 
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
 static const char nibble2str[16][5] = {
     "0000", "0001", "0010", "0011",
     "0100", "0101", "0110", "0111",
@@ -66,3 +72,82 @@ bool get_bit(std::vector<uint32_t> const& vector, size_t absolute_index)
     return bit;
 }
 
+void set_bits(std::vector<uint8_t>& vector, size_t begin, size_t end)
+{
+    if (begin >= end) return;
+
+    size_t first_byte = begin / 8;
+    size_t last_byte = (end - 1) / 8;
+    uint8_t first_mask = 0xFF << (begin % 8);
+    uint8_t last_mask = 0xFF >> (7 - (end - 1) % 8);
+
+    if (first_byte == last_byte)
+    {
+        vector[first_byte] |= first_mask & last_mask;
+        return;
+    }
+
+    vector[first_byte] |= first_mask;
+    std::fill(vector.begin() + first_byte + 1, vector.begin() + last_byte, 0xFF);
+    vector[last_byte] |= last_mask;
+}
+
+void set_bit(std::vector<uint8_t>& vector, size_t absolute_index, bool bit)
+{
+    uint8_t mask = 1 << (absolute_index % 8);
+    uint8_t& element = vector[absolute_index / 8];
+    element = bit ? (element | mask) : (element & ~mask);
+}
+
+static bool detect_avx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // AVX2 also needs the os to save the ymm registers (osxsave + xgetbv)
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__)
+    // libgcc checks the os support of the ymm registers as well
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool cpu_supports_avx2()
+{
+    static const bool supported = detect_avx2();
+    return supported;
+}
+
+static bool detect_bmi2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 8)) != 0;
+#elif defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+bool cpu_supports_bmi2()
+{
+    static const bool supported = detect_bmi2();
+    return supported;
+}
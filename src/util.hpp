@@ -14,13 +14,34 @@ constexpr int next_multiple(int number, int multiple)
 bool get_bit(std::vector<uint8_t> const& vector, size_t absolute_index);
 bool get_bit(std::vector<uint32_t> const& vector, size_t absolute_index);
 
+// sets the bits [begin, end) of a bitmap
+void set_bits(std::vector<uint8_t>& vector, size_t begin, size_t end);
+
+// sets or clears a single bit of a bitmap
+void set_bit(std::vector<uint8_t>& vector, size_t absolute_index, bool bit);
+
+// minimal number of bits for values up to max_value (at least 1)
+constexpr size_t bits_needed(uint64_t max_value)
+{
+    size_t bits = 1;
+    while (bits < 64 && (max_value >> bits) != 0) bits++;
+    return bits;
+}
+
+// runtime checks of the cpu (and os) support for AVX2 and BMI2, evaluated once
+bool cpu_supports_avx2();
+bool cpu_supports_bmi2();
+
 #if defined(_MSC_VER)
     #include <intrin.h>
     #define POPCNT(i) __popcnt(i)
+    #define POPCNT64(i) __popcnt64(i)
 #elif defined(__GNUC__)
     #define POPCNT(i) __builtin_popcount(i)
+    #define POPCNT64(i) __builtin_popcountll(i)
 #else
     #warning "Neither MVC nor GCC used for compilation!"
     #define POPCNT(i) (0)
+    #define POPCNT64(i) (0)
 #endif
 
@@ -0,0 +1,48 @@
+#include "catch.hpp"
+#include "simd_scan.hpp"
+#include "block_packed_column.hpp"
+#include "test_helpers.hpp"
+
+TEST_CASE("Block packed column", "[block-packed]")
+{
+    size_t input_size = 10007;
+
+    // mostly small values, a few blocks contain large outliers
+    std::vector<uint32_t> column(input_size);
+    for (size_t i = 0; i < input_size; i++)
+    {
+        column[i] = (uint32_t)(hash_index(i) % 13);
+    }
+    column[300] = 100000;
+    column[7000] = UINT32_MAX;
+
+    for (size_t block_size : { 128, 1024, 4096 })
+    {
+        INFO("block size " << block_size);
+
+        BlockPackedColumn column_block(column, block_size);
+        REQUIRE(column_block.size() == input_size);
+        REQUIRE(column_block.get_block_count() == (input_size + block_size - 1) / block_size);
+        REQUIRE(column_block.get_block_compression(300 / block_size) == 17);
+        REQUIRE(column_block.get_block_compression(7000 / block_size) == 32);
+        REQUIRE(column_block.get_block_compression(9000 / block_size) == 4);
+
+        // smaller than packing the whole column with the width of its largest value
+        REQUIRE(column_block.compressed_size() < compressed_buffer_size(32, input_size));
+
+        std::vector<int> result(decompression_output_buffer_size(input_size) / sizeof(int));
+        column_block.decompress(result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE((uint32_t)result[i] == column[i]);
+        }
+
+        std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+
+        check_bitmap(output, column, column_block.scan_equal(7, output), [](uint32_t x) { return x == 7; });
+        check_bitmap(output, column, column_block.scan_equal(100000, output), [](uint32_t x) { return x == 100000; });
+        check_bitmap(output, column, column_block.scan_equal(UINT32_MAX, output), [](uint32_t x) { return x == UINT32_MAX; });
+        check_bitmap(output, column, column_block.scan_between(3, 9, output), [](uint32_t x) { return x >= 3 && x <= 9; });
+        check_bitmap(output, column, column_block.scan_between(20, UINT32_MAX, output), [](uint32_t x) { return x >= 20; });
+    }
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <stdexcept>
+#include "catch.hpp"
+#include "simd_scan.hpp"
+#include "delta_column.hpp"
+#include "test_helpers.hpp"
+
+TEST_CASE("Delta column", "[delta]")
+{
+    size_t input_size = 5003;
+
+    for (uint64_t max_delta : { 0ull, 1ull, 100ull, 70000ull, 4000000000ull, 10000000000000ull })
+    {
+        std::vector<int64_t> values(input_size);
+        int64_t value = 1600000000000ll;
+        for (size_t i = 0; i < input_size; i++)
+        {
+            // runs of equal values and some large steps
+            value += max_delta == 0 || i % 5 == 0 ? 0 : hash_index(i) % (max_delta + 1);
+            values[i] = value;
+        }
+
+        INFO("max delta " << max_delta);
+
+        DeltaColumn column(values, 256);
+        REQUIRE(column.size() == input_size);
+
+        std::vector<int64_t> result(input_size + 1, -1);
+        column.decompress(result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE(result[i] == values[i]);
+        }
+        REQUIRE(result[input_size] == -1);
+
+        // ranges starting in the middle of a checkpoint interval
+        std::vector<int64_t> range(700, -1);
+        column.decompress_range(1000, 1700, range.data());
+        REQUIRE(std::equal(range.begin(), range.end(), values.begin() + 1000));
+        REQUIRE(column.get(4999) == values[4999]);
+        REQUIRE(column.get(input_size - 1) == values[input_size - 1]);
+        REQUIRE_THROWS_AS(column.get(input_size), std::out_of_range);
+
+        std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+
+        for (size_t index : { 0, 1, 255, 256, 2500, 5002 })
+        {
+            int64_t v = values[index];
+            check_bitmap(output, values, column.scan_equal(v, output), [&](int64_t x) { return x == v; });
+            check_bitmap(output, values, column.scan_equal(v + 1, output), [&](int64_t x) { return x == v + 1; });
+            check_bitmap(output, values, column.scan_between(v, values[std::min(index + 333, input_size - 1)], output),
+                [&](int64_t x) { return v <= x && x <= values[std::min(index + 333, input_size - 1)]; });
+        }
+        check_bitmap(output, values, column.scan_between(INT64_MIN, values[0] - 1, output), [](int64_t) { return false; });
+        check_bitmap(output, values, column.scan_between(INT64_MIN, INT64_MAX, output), [](int64_t) { return true; });
+    }
+}
+
+TEST_CASE("Delta column of unsorted values", "[delta]")
+{
+    std::vector<int64_t> values{ 1, 2, 3, 2, 5 };
+    REQUIRE_THROWS_AS(DeltaColumn(values, 32), std::invalid_argument);
+
+    // the drop is at a checkpoint
+    std::vector<int64_t> checkpoint_drop(64);
+    for (size_t i = 0; i < 32; i++)
+    {
+        checkpoint_drop[i] = 100 + i;
+        checkpoint_drop[32 + i] = i;
+    }
+    REQUIRE_THROWS_AS(DeltaColumn(checkpoint_drop, 32), std::invalid_argument);
+}
+
+TEST_CASE("Delta column with invalid checkpoint interval", "[delta]")
+{
+    std::vector<int64_t> values{ 1, 2, 3 };
+    REQUIRE_THROWS_AS(DeltaColumn(values, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(DeltaColumn(values, 100), std::invalid_argument);
+}
@@ -0,0 +1,85 @@
+#include <functional>
+#include "catch.hpp"
+#include "util.hpp"
+#include "dictionary.hpp"
+
+template <typename T>
+void check_dictionary_scans(std::vector<T> const& column, std::vector<T> const& probes)
+{
+    Dictionary<T> dictionary(column);
+    auto compressed = dictionary.compress(column);
+    __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+    // codes decode to the original values
+    auto codes = dictionary.encode(column);
+    for (size_t i = 0; i < column.size(); i++)
+    {
+        REQUIRE(dictionary.decode(codes[i]) == column[i]);
+    }
+
+    std::vector<uint8_t> output(scan_output_buffer_size(column.size()));
+    auto check = [&](CodeRange range, std::function<bool(T const&)> predicate)
+    {
+        int expected_hits = (int)std::count_if(column.begin(), column.end(), predicate);
+        REQUIRE(dictionary.scan(range, compressed_ptr, column.size(), output) == expected_hits);
+        for (size_t i = 0; i < column.size(); i++)
+        {
+            REQUIRE(get_bit(output, i) == predicate(column[i]));
+        }
+    };
+
+    for (T const& a : probes)
+    {
+        check(dictionary.equal(a), [&](T const& v) { return v == a; });
+        check(dictionary.less_than(a), [&](T const& v) { return v < a; });
+        check(dictionary.less_equal(a), [&](T const& v) { return v <= a; });
+        check(dictionary.greater_than(a), [&](T const& v) { return v > a; });
+        check(dictionary.greater_equal(a), [&](T const& v) { return v >= a; });
+
+        for (T const& b : probes)
+        {
+            check(dictionary.between(a, b), [&](T const& v) { return a <= v && v <= b; });
+        }
+    }
+}
+
+TEST_CASE("Dictionary encoded int64 column", "[dictionary]")
+{
+    std::vector<int64_t> column(1003);
+    for (size_t i = 0; i < column.size(); i++)
+    {
+        column[i] = (int64_t)((i * 2654435761u) % 300) * 1000000007ll - 150000000000ll;
+    }
+
+    Dictionary<int64_t> dictionary(column);
+    REQUIRE(dictionary.size() == 300);
+    REQUIRE(dictionary.compression() == 9);
+
+    check_dictionary_scans<int64_t>(column, { column[0], column[17], -150000000000ll, 0, INT64_MIN, INT64_MAX });
+}
+
+TEST_CASE("Dictionary encoded double column", "[dictionary]")
+{
+    std::vector<double> column(1003);
+    for (size_t i = 0; i < column.size(); i++)
+    {
+        column[i] = ((i * 7) % 41) * 0.25 - 3.0;
+    }
+
+    check_dictionary_scans<double>(column, { column[3], 0.1, -3.0, 7.0, -100.0, 100.0 });
+}
+
+TEST_CASE("Dictionary encoded string column", "[dictionary]")
+{
+    std::vector<std::string> words{ "apple", "banana", "cherry", "date", "elderberry", "fig", "grape" };
+    std::vector<std::string> column(1003);
+    for (size_t i = 0; i < column.size(); i++)
+    {
+        column[i] = words[(i * 3) % words.size()];
+    }
+
+    Dictionary<std::string> dictionary(column);
+    REQUIRE(dictionary.compression() == 3);
+
+    check_dictionary_scans<std::string>(column, { "banana", "c", "fig", "", "zzz" });
+}
@@ -0,0 +1,57 @@
+#include "catch.hpp"
+#include "simd_scan.hpp"
+#include "frame_of_reference_column.hpp"
+#include "test_helpers.hpp"
+
+TEST_CASE("Frame of reference column", "[frame-of-reference]")
+{
+    size_t input_size = 1003;
+
+    for (int64_t base : { int64_t(1600000000000), int64_t(-5000), INT64_MIN })
+    {
+        for (size_t spread_bits : { 1, 7, 13, 20, 31, 32, 33, 41, 63, 64 })
+        {
+            uint64_t spread_mask = spread_bits == 64 ? ~uint64_t(0) : (uint64_t(1) << spread_bits) - 1;
+
+            // the values have to stay below INT64_MAX
+            if (uint64_t(INT64_MAX) - uint64_t(base) < spread_mask) continue;
+
+            std::vector<int64_t> values(input_size);
+            for (size_t i = 0; i < input_size; i++)
+            {
+                values[i] = (int64_t)(uint64_t(base) + (hash_index(i) & spread_mask));
+            }
+            values[5] = base;
+            values[6] = (int64_t)(uint64_t(base) + spread_mask);
+
+            INFO("base " << base << ", spread " << spread_bits << " bit");
+
+            FrameOfReferenceColumn column(values);
+            REQUIRE(column.get_base() == base);
+            REQUIRE(column.get_compression() == spread_bits);
+
+            // elements past the end must not be written
+            std::vector<int64_t> result(input_size + 1, -1);
+            column.decompress(result.data());
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(result[i] == values[i]);
+            }
+            REQUIRE(result[input_size] == -1);
+
+            std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+
+            int64_t v = values[42];
+            check_bitmap(output, values, column.scan_equal(v, output), [&](int64_t x) { return x == v; });
+            check_bitmap(output, values, column.scan_between(v, INT64_MAX, output), [&](int64_t x) { return x >= v; });
+            check_bitmap(output, values, column.scan_between(INT64_MIN, v, output), [&](int64_t x) { return x <= v; });
+            check_bitmap(output, values, column.scan_between(values[7], values[8], output), [&](int64_t x) { return values[7] <= x && x <= values[8]; });
+
+            if (base != INT64_MIN)
+            {
+                check_bitmap(output, values, column.scan_equal(base - 1, output), [&](int64_t x) { return x == base - 1; });
+                check_bitmap(output, values, column.scan_between(INT64_MIN, base - 1, output), [](int64_t) { return false; });
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <cstring>
+#include "catch.hpp"
+#include "util.hpp"
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "packed_column.hpp"
+
+TEST_CASE("Append batches to packed column", "[packed-column]")
+{
+    std::vector<size_t> batch_sizes{ 1, 7, 13, 100, 3, 1000, 8, 0, 517 };
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        INFO("compression " << compression);
+
+        PackedColumn column(compression);
+        std::vector<uint32_t> appended;
+
+        for (size_t batch_size : batch_sizes)
+        {
+            std::vector<uint32_t> batch(batch_size);
+            for (size_t i = 0; i < batch_size; i++)
+            {
+                batch[i] = (uint32_t)((appended.size() + i) * 2654435761u) & code_mask(compression);
+            }
+
+            column.append(batch);
+            appended.insert(appended.end(), batch.begin(), batch.end());
+
+            REQUIRE(column.size() == appended.size());
+            REQUIRE(column.capacity() >= column.size());
+        }
+
+        // same layout as packing everything at once, including the zero padding
+        auto expected = compress_input(appended, compression);
+        size_t buffer_size = compressed_buffer_size(compression, appended.size()) / sizeof(uint64_t) * sizeof(uint64_t);
+        REQUIRE(memcmp(expected.get(), column.data(), buffer_size) == 0);
+
+        uint32_t predicate_key = appended[42];
+        std::vector<uint8_t> output(scan_output_buffer_size(column.size()));
+        int hits = scan(predicate_key, column.data(), column.size(), column.get_compression(), output);
+        REQUIRE(hits == std::count(appended.begin(), appended.end(), predicate_key));
+    }
+}
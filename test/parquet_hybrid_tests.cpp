@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "parquet_hybrid.hpp"
+#include "test_helpers.hpp"
+
+static void write_uleb128(std::vector<uint8_t>& output, uint64_t value)
+{
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        output.push_back(value != 0 ? byte | 0x80 : byte);
+    } while (value != 0);
+}
+
+static void write_rle_run(std::vector<uint8_t>& output, std::vector<uint32_t>& expected, uint32_t value, size_t count, size_t bit_width)
+{
+    write_uleb128(output, count << 1);
+    for (size_t i = 0; i < (bit_width + 7) / 8; i++)
+    {
+        output.push_back((uint8_t)(value >> (8 * i)));
+    }
+    expected.insert(expected.end(), count, value);
+}
+
+// values is padded to a multiple of 8, only count values are expected
+static void write_packed_run(std::vector<uint8_t>& output, std::vector<uint32_t>& expected, std::vector<uint32_t> values, size_t count, size_t bit_width)
+{
+    values.resize((values.size() + 7) / 8 * 8);
+    write_uleb128(output, (values.size() / 8) << 1 | 1);
+    if (bit_width > 0)
+    {
+        auto packed = compress_input(values, bit_width);
+        uint8_t* bytes = (uint8_t*)packed.get();
+        output.insert(output.end(), bytes, bytes + values.size() / 8 * bit_width);
+    }
+    expected.insert(expected.end(), values.begin(), values.begin() + count);
+}
+
+TEST_CASE("Parquet RLE/bit-packing hybrid", "[parquet]")
+{
+    for (size_t bit_width : { 0, 1, 3, 9, 17, 32 })
+    {
+        uint32_t mask = bit_width == 0 ? 0 : code_mask(bit_width);
+        auto values = [&](size_t count, size_t seed)
+        {
+            std::vector<uint32_t> result(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                result[i] = mixed_value(i + seed) & mask;
+            }
+            return result;
+        };
+
+        // RLE runs of odd lengths move the bit-packed runs off byte boundaries of the output
+        std::vector<uint8_t> page;
+        std::vector<uint32_t> expected;
+        write_rle_run(page, expected, 3 & mask, 13, bit_width);
+        write_packed_run(page, expected, values(40, 1), 40, bit_width);
+        write_packed_run(page, expected, values(2000, 2), 2000, bit_width);
+        write_rle_run(page, expected, mask, 1000, bit_width);
+        write_packed_run(page, expected, values(64, 3), 64, bit_width);
+        write_rle_run(page, expected, 1 & mask, 5, bit_width);
+        write_packed_run(page, expected, values(24, 4), 19, bit_width);
+
+        // trailing bytes after the values of the page are ignored
+        std::vector<uint8_t> data = page;
+        data.push_back(0xFF);
+
+        INFO("bit width " << bit_width);
+
+        ParquetHybridDecoder decoder(data.data(), data.size(), bit_width, expected.size());
+        REQUIRE(decoder.valid());
+        REQUIRE(decoder.size() == expected.size());
+        REQUIRE(decoder.get_run_count() == 7);
+
+        // values past the end must not be written
+        std::vector<int> result(decompression_output_buffer_size(expected.size()) / sizeof(int), -1);
+        decoder.decode(result.data());
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            REQUIRE((uint32_t)result[i] == expected[i]);
+        }
+        REQUIRE(result[expected.size()] == -1);
+
+        std::vector<uint8_t> output(scan_output_buffer_size(expected.size()));
+
+        uint32_t v = expected[500];
+        for (uint32_t key : { 0u, 1u, 3u, v, mask })
+        {
+            check_bitmap(output, expected, decoder.scan_equal(key, output), [&](uint32_t x) { return x == key; });
+        }
+        check_bitmap(output, expected, decoder.scan_between(1, 3, output), [](uint32_t x) { return 1 <= x && x <= 3; });
+        check_bitmap(output, expected, decoder.scan_between(v, UINT32_MAX, output), [&](uint32_t x) { return x >= v; });
+
+        // dictionary indices store the bit width in the first byte
+        std::vector<uint8_t> dictionary_page(1, (uint8_t)bit_width);
+        dictionary_page.insert(dictionary_page.end(), page.begin(), page.end());
+        auto indices = ParquetHybridDecoder::dictionary_indices(dictionary_page.data(), dictionary_page.size(), expected.size());
+        REQUIRE(indices.get_bit_width() == bit_width);
+        check_bitmap(output, expected, indices.scan_equal(v, output), [&](uint32_t x) { return x == v; });
+
+        // levels are prefixed with their length
+        uint32_t length = (uint32_t)page.size();
+        std::vector<uint8_t> levels_page((uint8_t*)&length, (uint8_t*)&length + sizeof(length));
+        levels_page.insert(levels_page.end(), page.begin(), page.end());
+        levels_page.insert(levels_page.end(), 100, 0xFF);
+        auto levels = ParquetHybridDecoder::levels(levels_page.data(), levels_page.size(), bit_width, expected.size());
+        check_bitmap(output, expected, levels.scan_between(0, v, output), [&](uint32_t x) { return x <= v; });
+
+        // truncated data leaves the decoder empty
+        if (bit_width > 0)
+        {
+            ParquetHybridDecoder truncated(page.data(), page.size() - 1, bit_width, expected.size());
+            REQUIRE(!truncated.valid());
+            REQUIRE(truncated.size() == 0);
+        }
+    }
+
+    ParquetHybridDecoder too_wide(nullptr, 0, 33, 10);
+    REQUIRE(!too_wide.valid());
+    REQUIRE(too_wide.size() == 0);
+}
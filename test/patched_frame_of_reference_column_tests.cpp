@@ -0,0 +1,62 @@
+#include "catch.hpp"
+#include "simd_scan.hpp"
+#include "patched_frame_of_reference_column.hpp"
+#include "test_helpers.hpp"
+
+TEST_CASE("Patched frame of reference column", "[patched-frame-of-reference]")
+{
+    size_t input_size = 10007;
+
+    for (int64_t base : { int64_t(1600000000000), int64_t(-5000), INT64_MIN })
+    {
+        for (size_t exception_count : { 0, 1, 20 })
+        {
+            // 10 bit offsets with a few outliers spreading up to 64 bits
+            std::vector<int64_t> values(input_size);
+            for (size_t i = 0; i < input_size; i++)
+            {
+                values[i] = (int64_t)(uint64_t(base) + (hash_index(i) & 1023));
+            }
+            values[5] = base;
+            for (size_t e = 0; e < exception_count; e++)
+            {
+                uint64_t outlier = e == 0 ? uint64_t(INT64_MAX) - uint64_t(base) : (uint64_t(1024) << (e % 50)) + e;
+                values[(e * 499 + 17) % input_size] = (int64_t)(uint64_t(base) + outlier);
+            }
+
+            INFO("base " << base << ", " << exception_count << " exceptions");
+
+            PatchedFrameOfReferenceColumn column(values);
+            REQUIRE(column.get_base() == base);
+            REQUIRE(column.get_compression() == 10);
+            REQUIRE(column.get_exception_count() == exception_count);
+            REQUIRE(column.compressed_size() < compressed_buffer_size(11, input_size));
+
+            // elements past the end must not be written
+            std::vector<int64_t> result(input_size + 1, -1);
+            column.decompress(result.data());
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(result[i] == values[i]);
+            }
+            REQUIRE(result[input_size] == -1);
+
+            std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+
+            // the outliers share their low bits with regular values
+            for (int64_t v : { values[42], values[17], values[516], int64_t(uint64_t(base) + 1024) })
+            {
+                check_bitmap(output, values, column.scan_equal(v, output), [&](int64_t x) { return x == v; });
+                check_bitmap(output, values, column.scan_between(v, INT64_MAX, output), [&](int64_t x) { return x >= v; });
+                check_bitmap(output, values, column.scan_between(INT64_MIN, v, output), [&](int64_t x) { return x <= v; });
+            }
+            check_bitmap(output, values, column.scan_between(values[7], values[8], output), [&](int64_t x) { return values[7] <= x && x <= values[8]; });
+
+            if (base != INT64_MIN)
+            {
+                check_bitmap(output, values, column.scan_equal(base - 1, output), [&](int64_t x) { return x == base - 1; });
+                check_bitmap(output, values, column.scan_between(INT64_MIN, base - 1, output), [](int64_t) { return false; });
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include <algorithm>
+#include "catch.hpp"
+#include "simd_scan.hpp"
+#include "run_length_column.hpp"
+#include "test_helpers.hpp"
+
+TEST_CASE("Run length column", "[run-length]")
+{
+    size_t input_size = 10007;
+
+    for (uint32_t max_value : { 1u, 12u, 1000u, UINT32_MAX })
+    {
+        // runs of 1 to 100 elements
+        std::vector<uint32_t> column;
+        for (size_t run = 0; column.size() < input_size; run++)
+        {
+            uint32_t value = (uint32_t)(hash_index(run) % (uint64_t(max_value) + 1));
+            size_t length = std::min((run * 37) % 100 + 1, input_size - column.size());
+            column.insert(column.end(), length, value);
+        }
+
+        INFO("max value " << max_value);
+
+        RunLengthColumn column_rle(column);
+        REQUIRE(column_rle.size() == input_size);
+        REQUIRE(column_rle.get_run_count() < input_size / 10);
+
+        std::vector<int> result(decompression_output_buffer_size(input_size) / sizeof(int));
+        column_rle.decompress(result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE((uint32_t)result[i] == column[i]);
+        }
+
+        std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+
+        uint32_t v = column[5000];
+        check_bitmap(output, column, column_rle.scan_equal(v, output), [&](uint32_t x) { return x == v; });
+        check_bitmap(output, column, column_rle.scan_equal(max_value / 2 + 1, output), [&](uint32_t x) { return x == max_value / 2 + 1; });
+        check_bitmap(output, column, column_rle.scan_between(0, v, output), [&](uint32_t x) { return x <= v; });
+        check_bitmap(output, column, column_rle.scan_between(v, UINT32_MAX, output), [&](uint32_t x) { return x >= v; });
+    }
+}
@@ -1,7 +1,11 @@
 #define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <functional>
 #include "catch.hpp"
 #include "util.hpp"
 #include "simd_scan.hpp"
+#include "simd_scan_commons.hpp"
+#include "test_helpers.hpp"
 
 TEST_CASE("Compress and decompress", "[simd-decompress]")
 {
@@ -21,7 +25,7 @@ TEST_CASE("Compress and decompress", "[simd-decompress]")
     {
         size_t output_buffer_size = decompression_output_buffer_size(input_size) / sizeof(int);
         auto result_buffer = std::make_unique<int[]>(output_buffer_size);
-        decompress_unvectorized(compressed_ptr, input_numbers.size(), result_buffer.get());
+        decompress_unvectorized(compressed_ptr, input_numbers.size(), BITS_NEEDED, result_buffer.get());
 
         for (size_t i = 0; i < input_numbers.size(); i++)
         {
@@ -33,7 +37,7 @@ TEST_CASE("Compress and decompress", "[simd-decompress]")
     {
         size_t output_buffer_size = decompression_output_buffer_size(input_size) / sizeof(int);
         auto result_buffer = std::make_unique<int[]>(output_buffer_size);
-        decompress_128_sweep(compressed_ptr, input_numbers.size(), result_buffer.get());
+        decompress_128_sweep(compressed_ptr, input_numbers.size(), BITS_NEEDED, result_buffer.get());
 
         for (size_t i = 0; i < input_numbers.size(); i++)
         {
@@ -42,6 +46,112 @@ TEST_CASE("Compress and decompress", "[simd-decompress]")
     }
 }
 
+TEST_CASE("Compress and decompress with variable bit width", "[simd-decompress]")
+{
+    // not a multiple of 8 or 32 elements to cover partial blocks
+    size_t input_size = 1003;
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = (uint32_t)(i * 2654435761u) & code_mask(compression);
+        }
+
+        auto compressed = compress_input(input_numbers, compression);
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        size_t output_buffer_size = decompression_output_buffer_size(input_size) / sizeof(int);
+        auto result_buffer = std::make_unique<int[]>(output_buffer_size);
+
+        auto check = [&]()
+        {
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(input_numbers[i] == (uint32_t)result_buffer[i]);
+            }
+        };
+
+        INFO("compression " << compression);
+
+        decompress_unvectorized(compressed_ptr, input_size, compression, result_buffer.get());
+        check();
+
+        decompress_128_wide(compressed_ptr, input_size, compression, result_buffer.get());
+        check();
+#if ENABLE_AVX2
+        if (cpu_supports_avx2())
+        {
+            decompress_256_wide(compressed_ptr, input_size, compression, result_buffer.get());
+            check();
+        }
+#endif
+
+        if (fits_shuffle_window(compression))
+        {
+            decompress_128_sweep(compressed_ptr, input_size, compression, result_buffer.get());
+            check();
+            decompress_128(compressed_ptr, input_size, compression, result_buffer.get());
+            check();
+            decompress_128_unrolled(compressed_ptr, input_size, compression, result_buffer.get());
+            check();
+            decompress_128_aligned(compressed_ptr, input_size, compression, result_buffer.get());
+            check();
+#if ENABLE_AVX2
+            if (cpu_supports_avx2())
+            {
+                decompress_256(compressed_ptr, input_size, compression, result_buffer.get());
+                check();
+                decompress_256_avx2(compressed_ptr, input_size, compression, result_buffer.get());
+                check();
+                decompress_256_permute(compressed_ptr, input_size, compression, result_buffer.get());
+                check();
+            }
+#endif
+        }
+    }
+}
+
+template <typename T>
+void check_narrow_decompression(std::function<void(__m128i*, size_t, size_t, T*)> function, size_t max_compression)
+{
+    size_t input_size = 1003;
+
+    for (size_t compression = 1; compression <= max_compression; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = (uint32_t)(i * 2654435761u) & code_mask(compression);
+        }
+
+        auto compressed = compress_input(input_numbers, compression);
+
+        INFO("compression " << compression);
+
+        std::vector<T> result(decompression_output_buffer_size(input_size, sizeof(T)) / sizeof(T));
+        function((__m128i*) compressed.get(), input_size, compression, result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE(input_numbers[i] == result[i]);
+        }
+    }
+}
+
+TEST_CASE("Narrow output decompression", "[simd-decompress]")
+{
+    check_narrow_decompression<uint16_t>(decompress_128_16bit, 16);
+    check_narrow_decompression<uint8_t>(decompress_128_8bit, 8);
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        check_narrow_decompression<uint16_t>(decompress_256_16bit, 16);
+        check_narrow_decompression<uint8_t>(decompress_256_8bit, 8);
+    }
+#endif
+}
+
 TEST_CASE("SIMD Scan", "[simd-scan]")
 {
     std::vector<uint16_t> input_numbers{ 1, 2, 3, 3, 2,
@@ -55,7 +165,7 @@ TEST_CASE("SIMD Scan", "[simd-scan]")
         auto output_buffer_size = scan_output_buffer_size(input_numbers.size());
         std::vector<uint8_t> output(output_buffer_size);
         int predicate_key = 3;
-        int hits = scan_unvectorized(predicate_key, compressed_ptr, input_numbers.size(), output);
+        int hits = scan_unvectorized(predicate_key, compressed_ptr, input_numbers.size(), BITS_NEEDED, output);
 
         REQUIRE(hits == 4);
 
@@ -70,7 +180,7 @@ TEST_CASE("SIMD Scan", "[simd-scan]")
         auto output_buffer_size = scan_output_buffer_size(input_numbers.size());
         std::vector<uint8_t> output(output_buffer_size);
         int predicate_key = 3;
-        int hits = scan_128(predicate_key, compressed_ptr, input_numbers.size(), output);
+        int hits = scan_128(predicate_key, compressed_ptr, input_numbers.size(), BITS_NEEDED, output);
 
         REQUIRE(hits == 4);
 
@@ -81,6 +191,539 @@ TEST_CASE("SIMD Scan", "[simd-scan]")
     }
 }
 
+TEST_CASE("SIMD Scan with variable bit width", "[simd-scan]")
+{
+    size_t input_size = 1003;
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = (uint32_t)(i % 7) & code_mask(compression);
+        }
+
+        auto compressed = compress_input(input_numbers, compression);
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        int predicate_key = 1;
+        int expected_hits = (int)std::count(input_numbers.begin(), input_numbers.end(), (uint32_t)predicate_key);
+
+        std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+
+        auto check = [&](int hits)
+        {
+            REQUIRE(hits == expected_hits);
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(get_bit(output, i) == (input_numbers[i] == (uint32_t)predicate_key));
+            }
+        };
+
+        INFO("compression " << compression);
+
+        check(scan_unvectorized(predicate_key, compressed_ptr, input_size, compression, output));
+        check(scan_128_wide(predicate_key, compressed_ptr, input_size, compression, output));
+#if ENABLE_AVX2
+        if (cpu_supports_avx2())
+        {
+            check(scan_256_wide(predicate_key, compressed_ptr, input_size, compression, output));
+        }
+#endif
+
+        if (fits_shuffle_window(compression))
+        {
+            check(scan_128(predicate_key, compressed_ptr, input_size, compression, output));
+            check(scan_128_unrolled(predicate_key, compressed_ptr, input_size, compression, output));
+#if ENABLE_AVX2
+            if (cpu_supports_avx2())
+            {
+                check(scan_256(predicate_key, compressed_ptr, input_size, compression, output));
+                check(scan_256_unrolled(predicate_key, compressed_ptr, input_size, compression, output));
+                check(scan_256_permute(predicate_key, compressed_ptr, input_size, compression, output));
+            }
+#endif
+
+            std::vector<int> predicate_keys{ 1, 2, 3 };
+            std::vector<std::vector<uint8_t>> outputs(predicate_keys.size(), std::vector<uint8_t>(scan_output_buffer_size(input_size)));
+
+            shared_scan_128_standard(predicate_keys, compressed_ptr, input_size, compression, outputs);
+            for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+            {
+                for (size_t i = 0; i < input_size; i++)
+                {
+                    REQUIRE(get_bit(outputs[key_id], i) == (input_numbers[i] == (uint32_t)predicate_keys[key_id]));
+                }
+            }
+#if ENABLE_AVX2
+            if (cpu_supports_avx2())
+            {
+                shared_scan_256_permute(predicate_keys, compressed_ptr, input_size, compression, outputs);
+                for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+                {
+                    for (size_t i = 0; i < input_size; i++)
+                    {
+                        REQUIRE(get_bit(outputs[key_id], i) == (input_numbers[i] == (uint32_t)predicate_keys[key_id]));
+                    }
+                }
+            }
+#endif
+        }
+
+        if (compression <= 8)
+        {
+            check(scan_128_8bit(predicate_key, compressed_ptr, input_size, compression, output));
+#if ENABLE_AVX2
+            if (cpu_supports_avx2())
+            {
+                check(scan_256_8bit(predicate_key, compressed_ptr, input_size, compression, output));
+            }
+#endif
+        }
+
+        if (compression <= 16)
+        {
+            check(scan_128_16bit(predicate_key, compressed_ptr, input_size, compression, output));
+#if ENABLE_AVX2
+            if (cpu_supports_avx2())
+            {
+                check(scan_256_16bit(predicate_key, compressed_ptr, input_size, compression, output));
+            }
+#endif
+
+            std::vector<int> predicate_keys{ 1, 2, 3 };
+            std::vector<std::vector<uint8_t>> outputs(predicate_keys.size(), std::vector<uint8_t>(scan_output_buffer_size(input_size)));
+
+            shared_scan_128_16bit(predicate_keys, compressed_ptr, input_size, compression, outputs);
+            for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+            {
+                for (size_t i = 0; i < input_size; i++)
+                {
+                    REQUIRE(get_bit(outputs[key_id], i) == (input_numbers[i] == (uint32_t)predicate_keys[key_id]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Width dispatched kernels", "[simd-dispatch]")
+{
+    size_t input_size = 1003;
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = (uint32_t)(i * 2654435761u % 5) & code_mask(compression);
+        }
+
+        auto compressed = compress_input(input_numbers, compression);
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        INFO("compression " << compression);
+
+        // elements past input_size must not be written
+        std::vector<int> result(input_size + 1, -1);
+        decompress(compressed_ptr, input_size, compression, result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE(input_numbers[i] == (uint32_t)result[i]);
+        }
+        REQUIRE(result[input_size] == -1);
+
+        // key 0 also matches the zero padding behind the input, which must not be counted
+        std::vector<int> predicate_keys{ 0, 1, 4 };
+        std::vector<std::vector<uint8_t>> outputs(predicate_keys.size(), std::vector<uint8_t>(scan_output_buffer_size(input_size)));
+
+        shared_scan(predicate_keys, compressed_ptr, input_size, compression, outputs);
+
+        for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+        {
+            uint32_t key = predicate_keys[key_id];
+            size_t expected_hits = std::count(input_numbers.begin(), input_numbers.end(), key);
+
+            std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+            int hits = scan(key, compressed_ptr, input_size, compression, output);
+            REQUIRE(hits == expected_hits);
+
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(get_bit(output, i) == (input_numbers[i] == key));
+                REQUIRE(get_bit(outputs[key_id], i) == (input_numbers[i] == key));
+            }
+            REQUIRE((output[input_size / 8] >> (input_size % 8)) == 0);
+        }
+
+        std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+        int hits = scan_range(1, 3, compressed_ptr, input_size, compression, output);
+        REQUIRE(hits == std::count_if(input_numbers.begin(), input_numbers.end(), [](uint32_t v) { return 1 <= v && v <= 3; }));
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE(get_bit(output, i) == (1 <= input_numbers[i] && input_numbers[i] <= 3));
+        }
+    }
+}
+
+typedef std::function<std::unique_ptr<uint64_t[]>(std::vector<uint32_t> const&, size_t)> CompressFunction;
+typedef std::function<void(__m128i*, size_t, size_t, int*)> DecompressionFunction;
+typedef std::function<int(int, __m128i*, size_t, size_t, std::vector<uint8_t>&)> ScanFunction;
+typedef std::function<int(uint32_t, uint32_t, __m128i*, size_t, size_t, std::vector<uint8_t>&)> ScanRangeFunction;
+
+/*
+* Checks the kernels of a layout for compression 1-32: decompression must not write past the
+* elements, scans for keys and ranges must match the elements exactly. Key 0 also matches the zero
+* padding of the last block or segment, which must not be counted.
+*/
+static void check_layout(CompressFunction compress, std::vector<DecompressionFunction> const& decompression_functions,
+    std::vector<ScanFunction> const& scan_functions, std::vector<ScanRangeFunction> const& scan_range_functions, size_t input_size = 1003)
+{
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        uint32_t mask = code_mask(compression);
+
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = mixed_value(i) & mask;
+        }
+
+        auto compressed = compress(input_numbers, compression);
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        INFO("compression " << compression << ", " << input_size << " elements");
+
+        for (auto const& decompression_function : decompression_functions)
+        {
+            std::vector<int> result(input_size + 1, -1);
+            decompression_function(compressed_ptr, input_size, compression, result.data());
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(input_numbers[i] == (uint32_t)result[i]);
+            }
+            REQUIRE(result[input_size] == -1);
+        }
+
+        std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+        uint32_t v = input_numbers[input_size - 4];
+
+        for (auto const& scan_function : scan_functions)
+        {
+            for (uint32_t key : { 0u, 1u, 4u, v, mask })
+            {
+                int hits = scan_function(key, compressed_ptr, input_size, compression, output);
+                check_bitmap(output, input_numbers, hits, [&](uint32_t x) { return x == key; });
+            }
+        }
+
+        for (auto const& scan_range_function : scan_range_functions)
+        {
+            // the last range is empty unless v + 1 wraps around
+            for (auto range : { std::make_pair(1u, 3u), std::make_pair(0u, v), std::make_pair(v, UINT32_MAX),
+                std::make_pair(0u, mask), std::make_pair(v / 2, v), std::make_pair(v + 1, v) })
+            {
+                int hits = scan_range_function(range.first, range.second, compressed_ptr, input_size, compression, output);
+                check_bitmap(output, input_numbers, hits, [&](uint32_t x) { return range.first <= x && x <= range.second; });
+            }
+        }
+    }
+}
+
+TEST_CASE("Vertical layout", "[vertical]")
+{
+    std::vector<DecompressionFunction> decompression_functions{ decompress_vertical_128, decompress_vertical };
+    std::vector<ScanFunction> scan_functions{ scan_vertical_128, scan_vertical };
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        decompression_functions.push_back(decompress_vertical_256);
+        scan_functions.push_back(scan_vertical_256);
+    }
+#endif
+
+    check_layout(compress_vertical<uint32_t>, decompression_functions, scan_functions, {});
+}
+
+TEST_CASE("BitWeaving/H layout", "[bitweaving-h]")
+{
+    check_layout(compress_bitweaving_h<uint32_t>, { decompress_bitweaving_h }, { scan_bitweaving_h }, { scan_range_bitweaving_h });
+}
+
+TEST_CASE("BitWeaving/V layout", "[bitweaving-v]")
+{
+    // the last segment is partial, exactly half (64 elements) and full
+    for (size_t input_size : { 1003, 64, 192, 256 })
+    {
+        check_layout(compress_bitweaving_v<uint32_t>, { decompress_bitweaving_v }, { scan_bitweaving_v }, { scan_range_bitweaving_v }, input_size);
+    }
+
+    size_t input_size = 1003;
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = mixed_value(i) & code_mask(compression);
+        }
+
+        INFO("compression " << compression);
+
+        // conversion from the packed layout gives the same slices, back to the same bytes
+        auto packed = compress_input(input_numbers, compression);
+        auto compressed = compress_bitweaving_v(input_numbers, compression);
+        auto converted = bitweaving_v_from_packed((__m128i*)packed.get(), input_size, compression);
+        REQUIRE(memcmp(compressed.get(), converted.get(), bitweaving_v_buffer_size(compression, input_size)) == 0);
+
+        auto repacked = bitweaving_v_to_packed((__m128i*)compressed.get(), input_size, compression);
+        REQUIRE(memcmp(packed.get(), repacked.get(), compressed_buffer_size(compression, input_size) / 8 * 8) == 0);
+    }
+}
+
+TEST_CASE("ByteSlice layout", "[byteslice]")
+{
+    std::vector<ScanFunction> scan_functions{ scan_byteslice_128, scan_byteslice };
+    std::vector<ScanRangeFunction> scan_range_functions{ scan_range_byteslice_128, scan_range_byteslice };
+#if ENABLE_AVX2
+    if (cpu_supports_avx2())
+    {
+        scan_functions.push_back(scan_byteslice_256);
+        scan_range_functions.push_back(scan_range_byteslice_256);
+    }
+#endif
+
+    check_layout(compress_byteslice<uint32_t>, { decompress_byteslice }, scan_functions, scan_range_functions);
+}
+
+TEST_CASE("SIMD compression", "[simd-compress]")
+{
+    // several chunks for compress_128_parallel
+    size_t input_size = 3 * (1 << 16) + 1003;
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        std::vector<uint16_t> input_numbers_16bit(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            // not masked, the packers have to drop the bits above compression
+            input_numbers[i] = (uint32_t)(i * 2654435761u);
+            input_numbers_16bit[i] = (uint16_t)input_numbers[i];
+        }
+
+        INFO("compression " << compression);
+
+        size_t buffer_size = compressed_buffer_size(compression, input_size) / sizeof(uint64_t) * sizeof(uint64_t);
+
+        auto expected = compress_input(input_numbers, compression);
+        auto compressed = compress_128(input_numbers, compression);
+        REQUIRE(memcmp(expected.get(), compressed.get(), buffer_size) == 0);
+
+        auto expected_16bit = compress_input(input_numbers_16bit, compression);
+        auto compressed_16bit = compress_128(input_numbers_16bit, compression);
+        REQUIRE(memcmp(expected_16bit.get(), compressed_16bit.get(), buffer_size) == 0);
+
+        auto compressed_parallel = compress_128_parallel(input_numbers, compression);
+        REQUIRE(memcmp(expected.get(), compressed_parallel.get(), buffer_size) == 0);
+    }
+}
+
+#if ENABLE_BMI2
+TEST_CASE("BMI2 kernels", "[bmi2]")
+{
+    if (!cpu_supports_bmi2()) return;
+
+    size_t input_size = 1003;
+
+    for (size_t compression = 1; compression <= 32; compression++)
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = i % 4 == 0 ? 1 : (uint32_t)(i * 2654435761u) & code_mask(compression);
+        }
+
+        INFO("compression " << compression);
+
+        // the packer has to produce the same bytes as compress_input, including the padding
+        auto compressed = compress_input(input_numbers, compression);
+        auto compressed_bmi2 = compress_input_bmi2(input_numbers, compression);
+        size_t buffer_size = compressed_buffer_size(compression, input_size) / sizeof(uint64_t) * sizeof(uint64_t);
+        REQUIRE(memcmp(compressed.get(), compressed_bmi2.get(), buffer_size) == 0);
+
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        std::vector<int> result(input_size + 1, -1);
+        decompress_bmi2(compressed_ptr, input_size, compression, result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE(input_numbers[i] == (uint32_t)result[i]);
+        }
+        REQUIRE(result[input_size] == -1);
+
+        for (uint32_t key : { 0u, 1u, code_mask(compression) })
+        {
+            size_t expected_hits = std::count(input_numbers.begin(), input_numbers.end(), key);
+
+            std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+            int hits = scan_bmi2(key, compressed_ptr, input_size, compression, output);
+            REQUIRE(hits == expected_hits);
+
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(get_bit(output, i) == (input_numbers[i] == key));
+            }
+            REQUIRE((output[input_size / 8] >> (input_size % 8)) == 0);
+        }
+    }
+}
+#endif
+
+TEST_CASE("64 bit elements", "[simd-64bit]")
+{
+    size_t input_size = 1003;
+
+    for (size_t compression = 33; compression <= 64; compression++)
+    {
+        uint64_t mask = compression == 64 ? ~uint64_t(0) : (uint64_t(1) << compression) - 1;
+
+        std::vector<uint64_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            // mostly large values, every third element is 7
+            input_numbers[i] = i % 3 == 0 ? 7 : (i * 0x9E3779B97F4A7C15ull) & mask;
+        }
+
+        auto compressed = compress_input(input_numbers, compression);
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        INFO("compression " << compression);
+
+        std::vector<std::function<void(__m128i*, size_t, size_t, uint64_t*)>> decompress_functions{ decompress_unvectorized_64bit, decompress_64bit };
+        std::vector<std::function<int(uint64_t, __m128i*, size_t, size_t, std::vector<uint8_t>&)>> scan_functions{ scan_unvectorized_64bit, scan_64bit };
+        std::vector<std::function<int(uint64_t, uint64_t, __m128i*, size_t, size_t, std::vector<uint8_t>&)>> scan_range_functions{ scan_range_unvectorized_64bit, scan_range_64bit };
+#if ENABLE_AVX2
+        if (cpu_supports_avx2())
+        {
+            decompress_functions.push_back(decompress_256_64bit);
+            scan_functions.push_back(scan_256_64bit);
+            scan_range_functions.push_back(scan_range_256_64bit);
+        }
+#endif
+
+        for (auto& function : decompress_functions)
+        {
+            std::vector<uint64_t> result(decompression_output_buffer_size(input_size, sizeof(uint64_t)) / sizeof(uint64_t));
+            function(compressed_ptr, input_size, compression, result.data());
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(input_numbers[i] == result[i]);
+            }
+        }
+
+        // frame of reference, the additions wrap around
+        std::vector<std::function<void(__m128i*, size_t, size_t, int64_t, int64_t*)>> decompress_for_functions{ decompress_for_64bit };
+#if ENABLE_AVX2
+        if (cpu_supports_avx2())
+        {
+            decompress_for_functions.push_back(decompress_for_256_64bit);
+        }
+#endif
+
+        for (auto& function : decompress_for_functions)
+        {
+            int64_t base = -1000000007;
+            std::vector<int64_t> result(decompression_output_buffer_size(input_size, sizeof(int64_t)) / sizeof(int64_t));
+            function(compressed_ptr, input_size, compression, base, result.data());
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(result[i] == (int64_t)(input_numbers[i] + uint64_t(base)));
+            }
+        }
+
+        for (auto& function : scan_functions)
+        {
+            // key 0 also matches the zero padding after the last element
+            for (uint64_t key : { uint64_t(0), uint64_t(7), input_numbers[1] })
+            {
+                std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+                int hits = function(key, compressed_ptr, input_size, compression, output);
+                REQUIRE(hits == std::count(input_numbers.begin(), input_numbers.end(), key));
+
+                for (size_t i = 0; i < input_size; i++)
+                {
+                    REQUIRE(get_bit(output, i) == (input_numbers[i] == key));
+                }
+                REQUIRE((output[input_size / 8] >> (input_size % 8)) == 0);
+            }
+        }
+
+        for (auto& function : scan_range_functions)
+        {
+            uint64_t pivot = input_numbers[1];
+            for (auto range : { std::make_pair(uint64_t(0), uint64_t(7)), std::make_pair(uint64_t(8), pivot), std::make_pair(pivot, mask) })
+            {
+                std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+                int hits = function(range.first, range.second, compressed_ptr, input_size, compression, output);
+
+                auto in_range = [&](uint64_t x) { return range.first <= x && x <= range.second; };
+                REQUIRE(hits == std::count_if(input_numbers.begin(), input_numbers.end(), in_range));
+
+                for (size_t i = 0; i < input_size; i++)
+                {
+                    REQUIRE(get_bit(output, i) == in_range(input_numbers[i]));
+                }
+                REQUIRE((output[input_size / 8] >> (input_size % 8)) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Aligned width kernels", "[simd-dispatch]")
+{
+    size_t input_size = 1003;
+
+    for (size_t compression : { 1, 2, 4, 8, 16, 32 })
+    {
+        std::vector<uint32_t> input_numbers(input_size);
+        for (size_t i = 0; i < input_size; i++)
+        {
+            input_numbers[i] = (uint32_t)(i * 2654435761u % 7) & code_mask(compression);
+        }
+
+        auto compressed = compress_input(input_numbers, compression);
+        __m128i* compressed_ptr = (__m128i*) compressed.get();
+
+        INFO("compression " << compression);
+
+        std::vector<int> result(input_size);
+        decompress(compressed_ptr, input_size, compression, result.data());
+        for (size_t i = 0; i < input_size; i++)
+        {
+            REQUIRE(input_numbers[i] == (uint32_t)result[i]);
+        }
+
+        std::vector<int> predicate_keys{ 0, 1, 2, 3, 5, 6 };
+        std::vector<std::vector<uint8_t>> outputs(predicate_keys.size(), std::vector<uint8_t>(scan_output_buffer_size(input_size)));
+        shared_scan(predicate_keys, compressed_ptr, input_size, compression, outputs);
+
+        for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
+        {
+            uint32_t key = predicate_keys[key_id];
+
+            std::vector<uint8_t> output(scan_output_buffer_size(input_size));
+            int hits = scan(key, compressed_ptr, input_size, compression, output);
+            REQUIRE(hits == std::count(input_numbers.begin(), input_numbers.end(), key));
+
+            for (size_t i = 0; i < input_size; i++)
+            {
+                REQUIRE(get_bit(output, i) == (input_numbers[i] == key));
+                REQUIRE(get_bit(outputs[key_id], i) == (input_numbers[i] == key));
+            }
+        }
+    }
+}
+
 TEST_CASE("Shared SIMD Scan", "[shared-simd-scan]")
 {
     std::vector<uint16_t> input_numbers{ 1, 2, 3, 3, 2,
@@ -94,7 +737,7 @@ TEST_CASE("Shared SIMD Scan", "[shared-simd-scan]")
     auto output_buffer_size = scan_output_buffer_size(input_numbers.size());
     std::vector<std::vector<uint8_t>> outputs(predicate_keys.size(), std::vector<uint8_t>(output_buffer_size));
 
-    shared_scan_128_sequential(predicate_keys, compressed_ptr, input_numbers.size(), outputs);
+    shared_scan_128_sequential(predicate_keys, compressed_ptr, input_numbers.size(), BITS_NEEDED, outputs);
 
     for (size_t key_id = 0; key_id < predicate_keys.size(); key_id++)
     {
@@ -122,8 +765,8 @@ TEST_CASE("Simple Shared SIMD Scan", "[simple-shared-scan]")
 
     SECTION("One key")
     {
-        shared_scan_128_linear_simple(predicate_keys1, compressed_ptr, input_numbers.size(), outputs1);
-        int hits = scan_128(predicate_keys1[0], compressed_ptr, input_numbers.size(), compare_output);
+        shared_scan_128_linear_simple(predicate_keys1, compressed_ptr, input_numbers.size(), BITS_NEEDED, outputs1);
+        int hits = scan_128(predicate_keys1[0], compressed_ptr, input_numbers.size(), BITS_NEEDED, compare_output);
 
         REQUIRE(hits == 4);
         REQUIRE(outputs1 == compare_output);
@@ -131,16 +774,16 @@ TEST_CASE("Simple Shared SIMD Scan", "[simple-shared-scan]")
 
     SECTION("Two keys")
     {
-        shared_scan_128_linear_simple(predicate_keys2, compressed_ptr, input_numbers.size(), outputs2);
+        shared_scan_128_linear_simple(predicate_keys2, compressed_ptr, input_numbers.size(), BITS_NEEDED, outputs2);
 
-        int hits = scan_128(predicate_keys2[0], compressed_ptr, input_numbers.size(), compare_output);
+        int hits = scan_128(predicate_keys2[0], compressed_ptr, input_numbers.size(), BITS_NEEDED, compare_output);
         REQUIRE(hits == 4);
         for (size_t i = 0; i < compare_output.size(); ++i)
         {
             REQUIRE(outputs2[i*2] == compare_output[i]);
         }
 
-        hits = scan_128(predicate_keys2[1], compressed_ptr, input_numbers.size(), compare_output);
+        hits = scan_128(predicate_keys2[1], compressed_ptr, input_numbers.size(), BITS_NEEDED, compare_output);
         REQUIRE(hits == 4);
         for (size_t i = 0; i < compare_output.size(); ++i)
         {
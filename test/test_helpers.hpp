@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "util.hpp"
+
+/*
+* Fixtures and checks shared by the column and layout tests
+*/
+
+// multiplicative hash (Knuth), spreads consecutive indices over the bits
+inline uint64_t hash_index(size_t i)
+{
+    return i * 2654435761u;
+}
+
+// every third value spreads over the bits (masked by the caller), the others are 0-4 to give the scans many hits
+inline uint32_t mixed_value(size_t i)
+{
+    return i % 3 == 0 ? (uint32_t)hash_index(i) : (uint32_t)(i % 5);
+}
+
+// checks a scan of values: the hits and every bit match predicate, no bits are set past the end
+template <typename T, typename Predicate>
+void check_bitmap(std::vector<uint8_t> const& output, std::vector<T> const& values, int hits, Predicate predicate)
+{
+    REQUIRE(hits == std::count_if(values.begin(), values.end(), predicate));
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        REQUIRE(get_bit(output, i) == predicate(values[i]));
+    }
+    REQUIRE((output[values.size() / 8] >> (values.size() % 8)) == 0);
+}
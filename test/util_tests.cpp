@@ -33,4 +33,44 @@ TEST_CASE("Get bit in vector", "[util]")
     REQUIRE(get_bit(vec, 13) == false);
     REQUIRE(get_bit(vec, 14) == false);
     REQUIRE(get_bit(vec, 15) == false);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Set bits in vector", "[util]")
+{
+    for (size_t begin = 0; begin < 24; begin++)
+    {
+        for (size_t end = begin; end <= 24; end++)
+        {
+            std::vector<uint8_t> vec(3, 0);
+            set_bits(vec, begin, end);
+
+            for (size_t i = 0; i < 24; i++)
+            {
+                REQUIRE(get_bit(vec, i) == (begin <= i && i < end));
+            }
+        }
+    }
+}
+
+TEST_CASE("Set single bit in vector", "[util]")
+{
+    std::vector<uint8_t> vec{ 0x0F, 0x00 };
+
+    set_bit(vec, 2, false);
+    set_bit(vec, 9, true);
+    set_bit(vec, 9, true);
+    set_bit(vec, 3, true);
+
+    REQUIRE(vec[0] == 0x0B);
+    REQUIRE(vec[1] == 0x02);
+}
+
+TEST_CASE("Bits needed for value", "[util]")
+{
+    REQUIRE(bits_needed(0) == 1);
+    REQUIRE(bits_needed(1) == 1);
+    REQUIRE(bits_needed(2) == 2);
+    REQUIRE(bits_needed(511) == 9);
+    REQUIRE(bits_needed(512) == 10);
+    REQUIRE(bits_needed(~uint64_t(0)) == 64);
+}